@@ -42,10 +42,30 @@ typedef struct {
     /* Optional accelerators */
     int		 s_lower;	/* Lowest label index */
     int		 s_upper;	/* Highest label index */
-    int		*s_accel;	/* Accelerator */
+    int		 s_accel;	/* Row of this state in g_acceltab */
     int		 s_accept;	/* Nonzero for accepting state */
 } state;
 
+/* An entry of the accelerator table.  All states' rows share the one
+   table, overlapping where their entries don't collide: the action for
+   label i in state s is g_acceltab[s->s_accel + i], provided that
+   s_lower <= i < s_upper and the entry's ac_check is s->s_accel.
+
+   Entries are 4 bytes, so that more of the table stays in cache; the
+   widths bound the grammar, and PyGrammar_AddAccelerators refuses one
+   that goes beyond them. */
+
+typedef struct {
+    short	 ac_check;	/* Row owning this entry, or -1 if free */
+    unsigned char ac_arrow;	/* State to go to */
+    signed char	 ac_push;	/* Nonterminal to push first, less NT_OFFSET,
+				   or -1 to shift the token */
+} accel;
+
+#define AC_MAXROW	SHRT_MAX	/* Largest s_accel */
+#define AC_MAXARROW	UCHAR_MAX	/* Most states in a DFA, less one */
+#define AC_MAXPUSH	SCHAR_MAX	/* Most nonterminals, less one */
+
 /* A DFA */
 
 typedef struct {
@@ -66,8 +86,25 @@ typedef struct {
     labellist	 g_ll;
     int		 g_start;	/* Start symbol of the grammar */
     int		 g_accel;	/* Set if accelerators present */
+    int		 g_naccel;	/* Entries in g_acceltab */
+    const accel	*g_acceltab;	/* Accelerator table */
+
+    /* Label lookup, built with the accelerators */
+    const int	*g_toklabel;	/* Label of each token type, or -1 */
+    const int	*g_kwlabel;	/* Keyword hash: label of each slot, or -1 */
+    unsigned int g_kwseed;	/* Hash multiplier, chosen to be perfect */
+    int		 g_kwshift;	/* 32 - log2 of the number of slots */
 } grammar;
 
+/* The slot of the NAME `str` in g_kwlabel.  The key packs the length and
+   the first, second and last bytes; AddAccelerators picks a seed under
+   which no two keywords share a slot, so one comparison settles it. */
+#define KW_KEY(str, len) \
+    ((unsigned int)(len) ^ (unsigned int)(str)[0] << 8 ^ \
+     (unsigned int)(str)[(len) > 1] << 16 ^ (unsigned int)(str)[(len) - 1] << 24)
+#define KW_SLOT(g, str, len) \
+    ((unsigned int)(KW_KEY(str, len) * (g)->g_kwseed) >> (g)->g_kwshift)
+
 /* FUNCTIONS */
 
 grammar *newgrammar(int start);
@@ -86,6 +123,7 @@ void PyGrammar_AddAccelerators(grammar *g);
 void PyGrammar_RemoveAccelerators(grammar *);
 
 void printgrammar(grammar *g, FILE *fp);
+void printdirect(grammar *g, FILE *fp);
 void printnonterminals(grammar *g, FILE *fp);
 
 #ifdef __cplusplus
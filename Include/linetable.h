@@ -0,0 +1,46 @@
+/* Line table interface */
+
+#ifndef Py_LINETABLE_H
+#define Py_LINETABLE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A line table maps byte offsets into a source string to (line, column)
+   pairs and back.  Lines are numbered from 1, as everywhere else in the
+   parser; columns from 0.  Offsets are 32-bit, so inputs are limited to
+   4 GB. */
+
+#define LT_BLOCK_SHIFT  8       /* Bytes per entry of lt_block, log2 */
+
+/* Units for columns */
+#define LT_BYTES        0
+#define LT_CODEPOINTS   1
+#define LT_UTF16        2
+
+typedef struct _linetable {
+    const unsigned char *lt_str;    /* Source string */
+    unsigned int    lt_length;      /* Its length in bytes */
+    int             lt_nlines;      /* Number of lines */
+    unsigned int    *lt_start;      /* Start offset of each line, plus
+                                       lt_length as a sentinel */
+    unsigned char   *lt_ascii;      /* Nonzero if the line is pure ASCII */
+    int             *lt_block;      /* Line index at each 1<<LT_BLOCK_SHIFT
+                                       byte boundary */
+} linetable;
+
+PyAPI_FUNC(linetable *) PyLineTable_New(const unsigned char *str, size_t length);
+PyAPI_FUNC(void) PyLineTable_Free(linetable *lt);
+PyAPI_FUNC(int) PyLineTable_Line(linetable *lt, size_t offset);
+PyAPI_FUNC(int) PyLineTable_Column(linetable *lt, size_t offset, int unit);
+PyAPI_FUNC(size_t) PyLineTable_Offset(linetable *lt, int line, int column, int unit);
+
+/* Line access macros, for 1 <= line <= lt_nlines */
+#define LT_LINESTART(lt, line)  ((lt)->lt_start[(line) - 1])
+#define LT_LINEEND(lt, line)    ((lt)->lt_start[(line)])
+#define LT_ISASCII(lt, line)    ((lt)->lt_ascii[(line) - 1])
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !Py_LINETABLE_H */
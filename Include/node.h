@@ -7,37 +7,114 @@
 extern "C" {
 #endif
 
+#include "token.h"      /* For ISTERMINAL */
+
+/* A terminal's node holds its token's text, which stays in the source
+   string; a nonterminal's holds its children.  That's 16 bytes on 64-bit
+   platforms.  Line numbers and columns aren't kept: PyNode_LineNo and
+   PyNode_ColOffset work them out from the source when asked. */
 typedef struct _node {
     short               n_type;
-    const unsigned char *n_str;
-    int                 n_str_length;
-    int                 n_lineno;
-    int                 n_col_offset;
-    int                 n_nchildren;
-    struct _node *n_child;
+    union {
+        int             n_nchildren;    /* Nonterminals */
+        int             n_str_length;   /* Terminals */
+    };
+    union {
+        struct _node    *n_child;
+        const unsigned char *n_str;
+    };
 } node;
 
+/* The nodes of a tree are kept together with its root.  PyNode_New makes
+   a root; PyNode_AddChild adds a child to `n`, a node of the tree under
+   the root `tree`; PyNode_Free frees the whole tree, given its root. */
 PyAPI_FUNC(node *) PyNode_New(int type);
-PyAPI_FUNC(int) PyNode_AddChild(node *n, int type,
-                                const unsigned char *str, size_t str_length,
-                                int lineno, int col_offset);
+PyAPI_FUNC(int) PyNode_AddChild(node *tree, node *n, int type,
+                                const unsigned char *str, size_t str_length);
 PyAPI_FUNC(void) PyNode_Free(node *n);
 Py_ssize_t _PyNode_SizeOf(node *n);
 
+/* Where a node starts in the source: the line and byte column of its
+   first token, or 0 and -1 if the tree doesn't know its source (see
+   _PyNode_SetSource).  Tokens without text, like INDENT, are placed at the
+   next token's text. */
+PyAPI_FUNC(int) PyNode_LineNo(node *tree, node *n);
+PyAPI_FUNC(int) PyNode_ColOffset(node *tree, node *n);
+
+/* Tell a tree the source its tokens' text is in, with its line table if
+   there is one already; the tree takes the line table, or else makes one
+   on the first call to PyNode_LineNo or PyNode_ColOffset. */
+struct _linetable;
+void _PyNode_SetSource(node *tree, const unsigned char *source,
+                       struct _linetable *lines);
+
 /* Node access functions */
-#define NCH(n)		((n)->n_nchildren)
+#define NCH(n)		(ISNONTERMINAL(TYPE(n)) ? (n)->n_nchildren : 0)
 
 #define CHILD(n, i)	(&(n)->n_child[i])
 #define RCHILD(n, i)	(CHILD(n, NCH(n) + i))
 #define TYPE(n)		((n)->n_type)
-#define STR(n)		((n)->n_str)
-#define STRL(n)         ((n)->n_str_length)
+#define STR(n)		(ISTERMINAL(TYPE(n)) ? (n)->n_str : NULL)
+#define STRL(n)         (ISTERMINAL(TYPE(n)) ? (n)->n_str_length : 0)
 
 /* Assert that the type of a node is what we expect */
 #define REQ(n, type) assert(TYPE(n) == (type))
 
 PyAPI_FUNC(void) PyNode_ListTree(node *);
 
+/* Walking a tree with a stack of its own rather than C's, so that however
+   deep the tree, the walk takes no more C stack than for one node.
+   PyNode_Visit goes through the subtree at `n` in order, calling with
+   `arg`: for a nonterminal, v_enter[TYPE(n) - NT_OFFSET] before its
+   children and v_leave[TYPE(n) - NT_OFFSET] after them; for a token,
+   v_token.  The tables have v_ntypes entries, N_NONTERMINALS from
+   graminit.h for Python's grammar, and may be NULL, as may any entry.
+
+   Each function returns 0 to go on, or an error code to stop the walk
+   with; v_enter may instead return NV_SKIP to pass over the children.
+   PyNode_Visit returns 0, or the error code, which may be its own E_NOMEM.
+   The tree mustn't change during the walk. */
+typedef int (*nodefunc)(void *arg, node *n);
+
+typedef struct {
+    const nodefunc      *v_enter;
+    const nodefunc      *v_leave;
+    int                 v_ntypes;
+    nodefunc            v_token;
+} nodevisitor;
+
+#define NV_SKIP         (-1)
+
+PyAPI_FUNC(int) PyNode_Visit(node *n, const nodevisitor *v, void *arg);
+
+/* A parse tree flattened into one array in post-order, as made by
+   PyParser_ParseStringNodeTape.  Each node comes right after its subtree,
+   which is the run of tn_size nodes ending with it: its last child is just
+   before it, and each earlier child just before the subtree of the one
+   after.  The root comes last.  Spans are byte offsets into the source, so
+   a tape holds no pointers and can be copied anywhere as it is; it is one
+   block, with no room beyond its nodes, freed with PyMem_FREE. */
+typedef struct {
+    int                 tn_type;
+    unsigned int        tn_start;       /* Offset of the node's text */
+    unsigned int        tn_length;      /* Its length in bytes */
+    unsigned int        tn_size;        /* Nodes in its subtree, with it */
+} tapenode;
+
+typedef struct {
+    unsigned int        nt_nnodes;
+    unsigned int        nt_size;        /* Room for this many nodes */
+    tapenode            nt_node[1];     /* Really nt_size of them */
+} nodetape;
+
+#define NT_ROOT(t)      (&(t)->nt_node[(t)->nt_nnodes - 1])
+#define NT_FIRST(n)     ((n) - (n)->tn_size + 1)  /* First of n's subtree */
+#define NT_LAST(n)      ((n) - 1)                 /* n's last child */
+#define NT_PREV(c)      ((c) - (c)->tn_size)      /* c's previous sibling */
+
+/* So a nonterminal n's children, last to first, are
+       for (c = NT_LAST(n); c >= NT_FIRST(n); c = NT_PREV(c)) ... */
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,6 +11,8 @@ typedef struct {
     int           error;
     int           lineno;
     int           offset;
+    int           utf16_offset;   /* Column of the error on line `lineno`,
+                                     in UTF-16 code units */
     unsigned char *text;
     int           token;
     int           expected;
@@ -29,11 +31,36 @@ typedef struct {
 #define PyPARSE_PRINT_IS_FUNCTION       0x0004
 #define PyPARSE_UNICODE_LITERALS        0x0008
 
+/* Callbacks for a parse that reports its nodes as they are made instead of
+   building a tree.  pc_push starts a nonterminal, pc_shift adds a token to
+   the innermost one, and pc_pop ends it; the start symbol is pushed first
+   and popped last.  Any of them may be NULL.  Each returns 0 to go on, or
+   an error code (E_NOMEM, E_ERROR, ...) to stop the parse with.  After a
+   syntax error the nonterminals still open are not popped. */
+typedef struct _parser_callbacks {
+    int (*pc_push)(void *arg, int type, int lineno, int col_offset);
+    int (*pc_shift)(void *arg, int type,
+                    const unsigned char *str, size_t str_length,
+                    int lineno, int col_offset);
+    int (*pc_pop)(void *arg, int type);
+} parser_callbacks;
 
 
 PyAPI_FUNC(node *) PyParser_ParseString(const unsigned char *, grammar *, int, perrdetail *);
 PyAPI_FUNC(node *) PyParser_ParseStringFlags(const unsigned char *, grammar *, int, perrdetail *, unsigned long);
 
+PyAPI_FUNC(node *) PyParser_ParseStringCollapsed(const unsigned char *, grammar *, int, const int *, perrdetail *);
+
+PyAPI_FUNC(nodetape *) PyParser_ParseStringNodeTape(const unsigned char *, grammar *, int, perrdetail *);
+
+PyAPI_FUNC(int) PyParser_RecognizeString(const unsigned char *, grammar *, int, perrdetail *);
+PyAPI_FUNC(int) PyParser_ParseStringCallbacks(const unsigned char *, grammar *, int,
+                                              const parser_callbacks *, void *,
+                                              perrdetail *);
+
+struct tok_tape;
+PyAPI_FUNC(node *) PyParser_ParseTape(const unsigned char *, const struct tok_tape *, grammar *, int, perrdetail *);
+
 /* Note that he following function is defined in pythonrun.c not parsetok.c. */
 PyAPI_FUNC(void) PyParser_SetError(perrdetail *);
 
@@ -1,5 +1,5 @@
-
 /* Token types */
+/* Generated by Parser/maketoken.py from Grammar/Tokens */
 
 #ifndef Py_TOKEN_H
 #define Py_TOKEN_H
@@ -64,7 +64,6 @@ extern "C" {
 #define CIRCLEDTIMES      52
 #define CIRCLEDPLUSEQUAL  53
 #define CIRCLEDTIMESEQUAL 54
-/* Don't forget to update the table _PyParser_TokenNames in tokenizer.c! */
 #define OP                55
 #define ERRORTOKEN        56
 #define N_TOKENS          57
@@ -80,9 +79,43 @@ extern "C" {
 #define ISEXTRAOP(x)      ((x) >= EXTRA_OP_OFFSET && (x) < EXTRA_OP_OFFSET + 4)
 
 PyAPI_DATA(const unsigned char *) _PyParser_TokenNames[]; /* Token names */
-PyAPI_FUNC(unsigned int) PyToken_OneChar(unsigned int);
-PyAPI_FUNC(unsigned int) PyToken_TwoChars(unsigned int, unsigned int);
-PyAPI_FUNC(unsigned int) PyToken_ThreeChars(unsigned int, unsigned int, unsigned int);
+
+/* Operator trie over UTF-8 bytes, in Parser/token.c.  _PyToken_OpStart maps
+   an operator's first byte to its state; state 0 is "no operator".  A
+   state's arcs run from _PyToken_OpArc[_PyToken_OpArcs[state]] up to a zero
+   byte. */
+PyAPI_DATA(const unsigned char) _PyToken_OpStart[256];
+PyAPI_DATA(const unsigned char) _PyToken_OpType[];
+PyAPI_DATA(const unsigned char) _PyToken_OpArcs[];
+PyAPI_DATA(const unsigned char) _PyToken_OpArc[][2];
+
+/* Find the longest operator starting at `p`, which is before `end`.  Return
+   its length in bytes and store its type in *type, or return 0 if there's
+   no operator at `p`. */
+static inline int
+PyToken_Match(const unsigned char *p, const unsigned char *end, int *type)
+{
+    int state = _PyToken_OpStart[*p];
+    int length = 0;
+    int i = 0;
+
+    while (state != 0) {
+        const unsigned char *arc;
+
+        i++;
+        if (_PyToken_OpType[state] != OP) {
+            length = i;
+            *type = _PyToken_OpType[state];
+        }
+        if (p + i == end)
+            break;
+        for (arc = _PyToken_OpArc[_PyToken_OpArcs[state]]; arc[0] != 0; arc += 2)
+            if (arc[0] == p[i])
+                break;
+        state = arc[1];
+    }
+    return length;
+}
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,438 @@
+#include "magicate.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "node.h"
+#include "grammar.h"
+#include "graminit.h"
+#include "token.h"
+#include "parsetok.h"
+#include "errcode.h"
+#include "Parser/tokenizer.h"
+
+/* Time the parser, and the tokenizer alone, over the files named on the
+   command line, built for either engine by the Makefile's bench target.
+   With -t N, only time parsing from 1 up to N threads at once (see
+   benchthreads). */
+
+#ifdef PY_PARSER_DIRECT
+#define ENGINE "direct"
+#else
+#define ENGINE "tables"
+#endif
+
+#define MIN_SECONDS 1.0
+#define DEEP        10000       /* Parens around the deep expression */
+
+extern grammar _PyParser_Grammar;
+
+void
+Py_Exit(int sts)
+{
+    exit(sts);
+}
+
+void
+Py_FatalError(const char *msg)
+{
+    fprintf(stderr, "Fatal Python error: %s\n", msg);
+    fflush(stderr);
+}
+
+static unsigned char *
+readfile(const char *filename)
+{
+    FILE *fp;
+    long len;
+    unsigned char *file;
+
+    fp = fopen(filename, "rb");
+    if (fp == NULL) {
+        perror(filename);
+        Py_Exit(1);
+    }
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    file = PyMem_MALLOC(len+1);
+    if (file == NULL || fread(file, 1, len, fp) != (size_t)len) {
+        fprintf(stderr, "can't read %s\n", filename);
+        Py_Exit(1);
+    }
+    file[len] = '\0';
+    fclose(fp);
+    return file;
+}
+
+static long
+counttokens(const unsigned char *source)
+{
+    struct tok_state *tok = PyTokenizer_FromString(source);
+    const unsigned char *a, *b;
+    long n = 0;
+    int type;
+
+    if (tok == NULL)
+        return 0;
+    do {
+        type = PyTokenizer_Get(tok, &a, &b);
+        n++;
+    } while (type != ENDMARKER && type != ERRORTOKEN);
+    PyTokenizer_Free(tok);
+    return n;
+}
+
+static double
+now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* What to time */
+#define TREE            0
+#define COLLAPSED       1
+#define NODETAPE        2
+#define RECOGNIZE       3
+#define TOKENIZE        4       /* PyTokenizer_Get alone */
+
+static const char *modes[] = {
+    "", ", collapsed", ", node tape", ", recognizing only",
+    ", tokenizing only"
+};
+
+/* Run the tokenizer alone over `source`; returns 0, or the error code */
+static int
+tokenize(const unsigned char *source, perrdetail *err)
+{
+    struct tok_state *tok = PyTokenizer_FromString(source);
+    const unsigned char *a, *b;
+    int type;
+
+    if (tok == NULL)
+        return err->error = E_NOMEM;
+    do
+        type = PyTokenizer_Get(tok, &a, &b);
+    while (type != ENDMARKER && type != ERRORTOKEN);
+    err->error = type == ERRORTOKEN ? tok->done : E_OK;
+    err->lineno = tok->lineno;
+    PyTokenizer_Free(tok);
+    return type == ERRORTOKEN ? err->error : 0;
+}
+
+/* Parse the file `source` one way; returns 0, or the error code */
+static int
+parse(int mode, const unsigned char *source, perrdetail *err)
+{
+    grammar *g = &_PyParser_Grammar;
+    nodetape *t;
+    node *n;
+
+    switch (mode) {
+    case TOKENIZE:
+        return tokenize(source, err);
+    case RECOGNIZE:
+        return PyParser_RecognizeString(source, g, g->g_start, err) == E_DONE ?
+            0 : err->error;
+    case NODETAPE:
+        t = PyParser_ParseStringNodeTape(source, g, g->g_start, err);
+        if (t == NULL)
+            return err->error;
+        PyMem_FREE(t);
+        return 0;
+    case COLLAPSED:
+        n = PyParser_ParseStringCollapsed(source, g, g->g_start, NULL, err);
+        break;
+    default:
+        n = PyParser_ParseString(source, g, g->g_start, err);
+    }
+    if (n == NULL)
+        return err->error;
+    PyNode_Free(n);
+    return 0;
+}
+
+/* Visiting: count the nodes, and how deep they go */
+typedef struct {
+    long c_nodes;
+    long c_atoms;
+    int c_depth;
+    int c_maxdepth;
+} counter;
+
+static int
+count_enter(void *arg, node *n)
+{
+    counter *c = (counter *)arg;
+
+    c->c_nodes++;
+    if (++c->c_depth > c->c_maxdepth)
+        c->c_maxdepth = c->c_depth;
+    return 0;
+}
+
+static int
+count_atom(void *arg, node *n)
+{
+    ((counter *)arg)->c_atoms++;
+    return count_enter(arg, n);
+}
+
+static int
+count_leave(void *arg, node *n)
+{
+    ((counter *)arg)->c_depth--;
+    return 0;
+}
+
+static int
+count_token(void *arg, node *n)
+{
+    ((counter *)arg)->c_nodes++;
+    return 0;
+}
+
+/* Time walking the tree of an expression DEEP parens deep, which would
+   take a C stack frame per level (15 of them per paren) to walk
+   recursively */
+static void
+benchdeep(void)
+{
+    grammar *g = &_PyParser_Grammar;
+    static nodefunc enter[N_NONTERMINALS], leave[N_NONTERMINALS];
+    nodevisitor v = {enter, leave, N_NONTERMINALS, count_token};
+    unsigned char *source;
+    perrdetail err;
+    counter c;
+    long rounds = 0;
+    double start, elapsed;
+    node *n;
+    int i;
+
+    for (i = 0; i < N_NONTERMINALS; i++) {
+        enter[i] = count_enter;
+        leave[i] = count_leave;
+    }
+    enter[atom - NT_OFFSET] = count_atom;
+
+    source = PyMem_MALLOC(2 * DEEP + 3);
+    if (source == NULL)
+        Py_Exit(1);
+    memset(source, '(', DEEP);
+    memcpy(source + DEEP, "1", 1);
+    memset(source + DEEP + 1, ')', DEEP);
+    memcpy(source + 2 * DEEP + 1, "\n", 2);
+
+    start = now();
+    n = PyParser_ParseString(source, g, g->g_start, &err);
+    elapsed = now() - start;
+    if (n == NULL) {
+        fprintf(stderr, "deep expression: error %d\n", err.error);
+        Py_Exit(1);
+    }
+    printf("%s, %d-deep expression: parsed in %.1f ms\n", ENGINE, DEEP,
+           elapsed * 1e3);
+
+    start = now();
+    do {
+        memset(&c, 0, sizeof(c));
+        if (PyNode_Visit(n, &v, &c) != 0) {
+            fprintf(stderr, "deep expression: no memory to visit\n");
+            Py_Exit(1);
+        }
+        rounds++;
+        elapsed = now() - start;
+    } while (elapsed < MIN_SECONDS);
+    printf("%s, %d-deep expression: visited %.0f nodes/s "
+           "(%ld nodes, %ld atoms, %d deep, %ld rounds)\n", ENGINE, DEEP,
+           c.c_nodes * rounds / elapsed, c.c_nodes, c.c_atoms, c.c_maxdepth,
+           rounds);
+
+    PyNode_Free(n);
+    PyMem_FREE(source);
+}
+
+/* Threads parsing at once: each parses and magicates every file, over and
+   over, on the one grammar, and checks magicate's output against what it
+   was with one thread */
+typedef struct {
+    unsigned char **w_files;
+    unsigned char **w_expected;
+    int w_nfiles;
+    double w_stop;      /* When to stop, by now() */
+    long w_rounds;
+    int w_failed;
+} worker;
+
+static void *
+work(void *arg)
+{
+    worker *w = (worker *)arg;
+    grammar *g = &_PyParser_Grammar;
+    int i;
+
+    do {
+        for (i = 0; i < w->w_nfiles; i++) {
+            perrdetail err;
+            node *n = PyParser_ParseString(w->w_files[i], g, g->g_start, &err);
+            unsigned char *m = magicate(w->w_files[i]);
+
+            if (n == NULL || m == NULL ||
+                strcmp((char *)m, (char *)w->w_expected[i]) != 0)
+                w->w_failed = 1;
+            PyNode_Free(n);
+            free(m);
+        }
+        w->w_rounds++;
+    } while (!w->w_failed && now() < w->w_stop);
+    return NULL;
+}
+
+/* Time the files from 1, 2, 4, ... and `maxthreads` threads at once.  The
+   throughput per thread should hold steady up to the number of cores. */
+static void
+benchthreads(char **names, unsigned char **files, int nfiles, long tokens,
+             int maxthreads)
+{
+    unsigned char **expected;
+    pthread_t *threads;
+    worker *workers;
+    double start, elapsed, rate1 = 0;
+    size_t size;
+    int i, nthreads;
+
+    size = nfiles * sizeof(unsigned char *);
+    expected = PyMem_MALLOC(size);
+    size = maxthreads * sizeof(pthread_t);
+    threads = PyMem_MALLOC(size);
+    size = maxthreads * sizeof(worker);
+    workers = PyMem_MALLOC(size);
+    if (expected == NULL || threads == NULL || workers == NULL)
+        Py_Exit(1);
+    for (i = 0; i < nfiles; i++) {
+        perrdetail err;
+
+        if (parse(TREE, files[i], &err) != 0) {
+            fprintf(stderr, "%s: error %d on line %d\n",
+                    names[i], err.error, err.lineno);
+            Py_Exit(1);
+        }
+        expected[i] = magicate(files[i]);
+        if (expected[i] == NULL) {
+            fprintf(stderr, "%s: doesn't magicate\n", names[i]);
+            Py_Exit(1);
+        }
+    }
+
+    for (nthreads = 1; ; nthreads = nthreads * 2 < maxthreads ?
+                                    nthreads * 2 : maxthreads) {
+        long rounds = 0;
+
+        start = now();
+        for (i = 0; i < nthreads; i++) {
+            workers[i].w_files = files;
+            workers[i].w_expected = expected;
+            workers[i].w_nfiles = nfiles;
+            workers[i].w_stop = start + MIN_SECONDS;
+            workers[i].w_rounds = 0;
+            workers[i].w_failed = 0;
+            if (pthread_create(&threads[i], NULL, work, &workers[i]) != 0) {
+                fprintf(stderr, "can't start thread %d\n", i + 1);
+                Py_Exit(1);
+            }
+        }
+        for (i = 0; i < nthreads; i++) {
+            pthread_join(threads[i], NULL);
+            if (workers[i].w_failed) {
+                fprintf(stderr, "%d threads: thread %d went wrong\n",
+                        nthreads, i + 1);
+                Py_Exit(1);
+            }
+            rounds += workers[i].w_rounds;
+        }
+        elapsed = now() - start;
+        if (nthreads == 1)
+            rate1 = rounds / elapsed;
+
+        printf("%s, %d threads, parse and magicate: %.0f tokens/s, "
+               "%.0f per thread, %.2fx one thread (%ld rounds)\n", ENGINE,
+               nthreads, tokens * rounds / elapsed,
+               tokens * rounds / elapsed / nthreads,
+               rounds / elapsed / rate1, rounds);
+        if (nthreads == maxthreads)
+            break;
+    }
+
+    for (i = 0; i < nfiles; i++)
+        free(expected[i]);
+    PyMem_FREE(expected);
+    PyMem_FREE(threads);
+    PyMem_FREE(workers);
+}
+
+int
+main(int argc, char **argv)
+{
+    unsigned char **files;
+    long tokens = 0, rounds;
+    size_t bytes = 0;
+    double start, elapsed;
+    size_t size = argc * sizeof(unsigned char *);
+    int i, mode, first = 1, maxthreads, threadsonly = 0;
+
+    maxthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc >= 3 && strcmp(argv[1], "-t") == 0) {
+        maxthreads = atoi(argv[2]);
+        threadsonly = 1;
+        first = 3;
+    }
+    if (argc <= first || maxthreads < 1) {
+        fprintf(stderr, "usage: %s [-t threads] x.py ...\n", argv[0]);
+        Py_Exit(2);
+    }
+    files = PyMem_MALLOC(size);
+    if (files == NULL)
+        Py_Exit(1);
+    for (i = first; i < argc; i++) {
+        files[i] = readfile(argv[i]);
+        tokens += counttokens(files[i]);
+        bytes += strlen((char *)files[i]);
+    }
+
+    if (threadsonly) {
+        benchthreads(argv + first, files + first, argc - first, tokens,
+                     maxthreads);
+        Py_Exit(0);
+    }
+
+    for (mode = TREE; mode <= TOKENIZE; mode++) {
+        rounds = 0;
+        start = now();
+        do {
+            for (i = first; i < argc; i++) {
+                perrdetail err;
+                if (parse(mode, files[i], &err) != 0) {
+                    fprintf(stderr, "%s: error %d on line %d\n",
+                            argv[i], err.error, err.lineno);
+                    Py_Exit(1);
+                }
+            }
+            rounds++;
+            elapsed = now() - start;
+        } while (elapsed < MIN_SECONDS);
+
+        printf("%s%s: %.0f tokens/s, %.1f MB/s (%ld tokens, %ld rounds)\n",
+               ENGINE, modes[mode], tokens * rounds / elapsed,
+               bytes * rounds / elapsed / 1e6, tokens, rounds);
+    }
+
+    benchdeep();
+    benchthreads(argv + first, files + first, argc - first, tokens,
+                 maxthreads);
+    Py_Exit(0);
+    return 0;
+}
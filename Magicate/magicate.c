@@ -4,166 +4,684 @@
 #include "grammar.h"
 #include "graminit.h"
 #include "token.h"
+#include "errcode.h"
 #include "parsetok.h"
 
+#include <ctype.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 extern grammar _PyParser_Grammar;
 
+#define OPLUS       ").___oplus___("
+#define OTIMES      ").___otimes___("
+#define IOPLUS      ").___ioplus___("
+#define IOTIMES     ").___iotimes___("
+
 const unsigned char *_Magicate_Magic[] = {
-    CUC(").___oplus___("),
-    CUC(").___otimes___("),
-    CUC(").___ioplus___("),
-    CUC(").___iotimes___(")
+    CUC(OPLUS),
+    CUC(OTIMES),
+    CUC(IOPLUS),
+    CUC(IOTIMES)
 };
 
-const unsigned char *advance(unsigned char **target, const unsigned char *source, size_t length)
+static const size_t magic_width[] = {
+    sizeof(OPLUS) - 1,
+    sizeof(OTIMES) - 1,
+    sizeof(IOPLUS) - 1,
+    sizeof(IOTIMES) - 1
+};
+
+/*
+ * The rewrite follows the parse as it happens, through the parser's
+ * callbacks, so no tree gets built.  Of the parse it keeps only the
+ * arith_expr and term nodes open on the parser's stack; of the output, a
+ * list of edits to the source.  Each extra op becomes `).___some_op___(`,
+ * the operand after it gets a closing `)`, and an arith_expr or term with k
+ * extra ops gets k leading parens.  Those leading parens are only known
+ * once their node pops, after the edits inside it, so they go on a list of
+ * their own.  The edits keep count of how much they grow the source by, so
+ * once the parse is done the output is written in one go: a copy of each
+ * unchanged span between edits, and the edits' text.
+ */
+
+typedef struct {
+    size_t e_offset;                // Where in the source
+    size_t e_length;                // How many source bytes to drop there
+    const unsigned char *e_text;    // What to write in their place...
+    size_t e_width;                 // ...which is this long...
+    size_t e_count;                 // ...and how many times
+} edit;
+
+typedef struct {
+    edit *el_edit;
+    size_t el_n;
+    size_t el_size;
+    size_t el_growth;   // Bytes the edits add to the source, net
+} editlist;
+
+typedef struct {
+    int f_depth;        // Parser stack depth of the arith_expr or term
+    size_t f_start;     // Where its leading parens go
+    size_t f_extra;     // Extra ops among its children so far
+    int f_close;        // Whether its current child needs a closing paren
+} frame;
+
+// A logical line with an extra op in its code
+typedef struct {
+    size_t r_start;     // Its first byte of code
+    size_t r_end;       // Just beyond its last byte of code
+    size_t r_stop;      // Just beyond its newline, or the source's end
+    size_t r_prev;      // Just beyond the last byte of code before it
+} region;
+
+typedef struct {
+    const unsigned char *m_source;
+    size_t m_length;    // Its length
+    const unsigned char *m_text;    // The source being parsed, or a copy of
+    size_t m_start;                 // it from m_start...
+    size_t m_stop;                  // ...to m_stop
+    size_t m_end;       // Just beyond the last token with text, not a comment
+    int m_depth;        // Nonterminals open on the parser's stack
+    frame *m_frame;
+    int m_nframes;
+    int m_size;
+    editlist m_edits;   // In source order
+    editlist m_opens;   // Leading parens, in the order their nodes pop
+    region *m_region;   // The logical lines to parse, in order
+    size_t m_nregions;
+    size_t m_regionsize;
+    unsigned char *m_buf;   // Where a logical line is copied to parse
+    size_t m_bufsize;
+} magicator;
+
+static int addedit(editlist *el, size_t offset, size_t length,
+                   const unsigned char *text, size_t width, size_t count)
 {
-#ifndef NDEBUG
-    printf("printing '%.*s' to target\n", (int)length, source);
-#endif
+    edit *e;
 
-    memcpy(*target, source, length);
-    *target += length;
+    if (el->el_n == el->el_size) {
+        size_t n = el->el_size ? 2 * el->el_size : 16;
+        size_t size = n * sizeof(edit);
 
-    return source + length;
+        e = PyMem_REALLOC(el->el_edit, size);
+        if (e == NULL)
+            return E_NOMEM;
+        el->el_edit = e;
+        el->el_size = n;
+    }
+    e = &el->el_edit[el->el_n++];
+    e->e_offset = offset;
+    e->e_length = length;
+    e->e_text = text;
+    e->e_width = width;
+    e->e_count = count;
+    el->el_growth += width * count - length;
+    return 0;
 }
 
-// TODO: Validate AugAssign LHS, currently this produces code that runs under
-// Python contrary to proper AugAssign operators.
-const unsigned char *branch(const node *n, const unsigned char *source, unsigned char **target)
-{
-    unsigned int i;
-    size_t length;
-    const unsigned char *method;
-    const node *child;
-
-    if (NCH(n) == 0 && STRL(n) > 0) {
-        length = STR(n) + STRL(n) - source;
-        return advance(target, source, length);
-    }
-
-    switch (TYPE(n)) {
-    case atom:
-        for (i=0; i<NCH(n); ++i) {
-            child = CHILD(n, i);
-            switch (TYPE(child)) {
-            case LPAR:
-            case RPAR:
-                assert(NCH(n) == 3);
-                break;
-            default:
-                source = branch(child, source, target);
-                continue;
-            }
+static frame *topframe(magicator *m)
+{
+    return m->m_nframes > 0 ? &m->m_frame[m->m_nframes - 1] : NULL;
+}
 
-            length = STR(child) + STRL(child) - source;
-            source = advance(target, source, length);
-        }
-        break;
-    case arith_expr:
-    case term:
+static int on_push(void *arg, int type, int lineno, int col_offset)
+{
+    magicator *m = arg;
+    frame *f;
+
+    m->m_depth++;
+    if (type != arith_expr && type != term)
+        return 0;
+
+    if (m->m_nframes == m->m_size) {
+        int n = m->m_size ? 2 * m->m_size : 16;
+        size_t size = n * sizeof(frame);
+
+        f = PyMem_REALLOC(m->m_frame, size);
+        if (f == NULL)
+            return E_NOMEM;
+        m->m_frame = f;
+        m->m_size = n;
+    }
+    f = &m->m_frame[m->m_nframes++];
+    f->f_depth = m->m_depth;
+    f->f_start = m->m_end;
+    f->f_extra = 0;
+    f->f_close = 0;
+    return 0;
+}
+
+static int on_shift(void *arg, int type, const unsigned char *str,
+                    size_t str_length, int lineno, int col_offset)
+{
+    magicator *m = arg;
+    frame *f = topframe(m);
+    size_t offset;
+
+    // What a logical line is wrapped in to parse alone has no ops to
+    // rewrite, and no place for parens.
+    if (str < m->m_text || str >= m->m_text + (m->m_stop - m->m_start))
+        return 0;
+    offset = str - m->m_text + m->m_start;
+
+    if (f != NULL && f->f_depth == m->m_depth && ISEXTRAOP(type)) {
         /*
-         * For each extra op, insert a leading paren.  Each of these gets
-         * closed by a `).___some_op___(`.  Left to right associativity.
+         * All of my extraop types are binary, so there is always a trailing
+         * operand to close.
          */
-        for (i=(NCH(n) - 1)/2; i>0; --i) {
-            if (ISEXTRAOP(TYPE(CHILD(n, i*2 - 1)))) {
-#ifndef NDEBUG
-    printf("printing '(' to target\n");
-#endif
-                **target = '(';
-                *target += 1;
-            }
-        }
+        if (addedit(&m->m_edits, offset, str_length,
+                    _Magicate_Magic[type - EXTRA_OP_OFFSET],
+                    magic_width[type - EXTRA_OP_OFFSET], 1))
+            return E_NOMEM;
+        f->f_extra++;
+        f->f_close = 1;
+    }
 
-        for (i=0; i<NCH(n); ++i) {
-            child = CHILD(n, i);
+    // A NEWLINE's text is any comment before it, and a paren there would
+    // be commented out
+    if (str_length > 0 && type != NEWLINE)
+        m->m_end = offset + str_length;
+    return 0;
+}
 
-            if (!ISEXTRAOP(TYPE(child))) {
-                source = branch(child, source, target);
-                continue;
-            }
+static int on_pop(void *arg, int type)
+{
+    magicator *m = arg;
+    frame *f = topframe(m);
+
+    if (f != NULL && f->f_depth == m->m_depth) {
+        // For each extra op, a leading paren.  Left to right associativity.
+        if (f->f_extra > 0 &&
+            addedit(&m->m_opens, f->f_start, 0, CUC("("), 1, f->f_extra))
+            return E_NOMEM;
+        m->m_nframes--;
+        f = topframe(m);
+    }
+    m->m_depth--;
+
+    // Close `).___some_op___(` after the operand that follows it.
+    if (f != NULL && f->f_depth == m->m_depth && f->f_close) {
+        if (addedit(&m->m_edits, m->m_end, 0, CUC(")"), 1, 1))
+            return E_NOMEM;
+        f->f_close = 0;
+    }
+    return 0;
+}
 
-            /*
-             * All of my extraop types are binary, so there is always a trailing
-             * operand.
-             */
-            assert(i != NCH(n)-1);
+static int compare_offsets(const void *a, const void *b)
+{
+    size_t x = ((const edit *)a)->e_offset;
+    size_t y = ((const edit *)b)->e_offset;
+
+    return x < y ? -1 : x > y;
+}
+
+// The edits in source order, from m_edits and m_opens (sorted) by turns;
+// *i and *j are where each list is up to.  NULL after the last.
+static const edit *nextedit(magicator *m, size_t *i, size_t *j)
+{
+    editlist *edits = &m->m_edits, *opens = &m->m_opens;
+
+    if (*i == edits->el_n && *j == opens->el_n)
+        return NULL;
+    // Where an edit and leading parens coincide, the edit goes first.
+    if (*j == opens->el_n ||
+        (*i < edits->el_n &&
+         edits->el_edit[*i].e_offset <= opens->el_edit[*j].e_offset))
+        return &edits->el_edit[(*i)++];
+    return &opens->el_edit[(*j)++];
+}
 
-            // Print up to the old operator-token.
+// Apply the edits to the source, which is m_length long.
+static unsigned char *emit(magicator *m)
+{
+    const unsigned char *source = m->m_source;
+    unsigned char *result, *t;
+    const edit *e;
+    size_t i, j, k, from;
+
+    t = result = malloc(m->m_length + m->m_edits.el_growth +
+                        m->m_opens.el_growth + 1);
+    if (result == NULL)
+        return NULL;
+
+    from = 0;
+    i = j = 0;
+    while ((e = nextedit(m, &i, &j)) != NULL) {
 #ifndef NDEBUG
-    printf("printing up to old token '%.*s' to target\n", (int)(STR(child)-source), source);
+    printf("printing '%.*s' to target\n",
+           (int)(e->e_offset - from), source + from);
 #endif
-            source = advance(target, source, STR(child)-source);
+        // Everything since the last edit is unchanged: one copy.
+        if (e->e_offset > from) {
+            memcpy(t, source + from, e->e_offset - from);
+            t += e->e_offset - from;
+        }
 
-            // Print the operator-token replacement.
-            method = _Magicate_Magic[TYPE(child) - EXTRA_OP_OFFSET];
 #ifndef NDEBUG
-    printf("printing '%s' to target\n", method);
+        for (k = 0; k < e->e_count; ++k)
+            printf("printing '%s' to target\n", e->e_text);
 #endif
-            length = strlen((const char *)method);
-            memcpy(*target, method, length);
-            *target += length;
-            source += STRL(child); // Move just beyond the old operator-token.
+        if (e->e_width == 1) {
+            memset(t, e->e_text[0], e->e_count);
+            t += e->e_count;
+        }
+        else {
+            for (k = 0; k < e->e_count; ++k) {
+                memcpy(t, e->e_text, e->e_width);
+                t += e->e_width;
+            }
+        }
+        from = e->e_offset + e->e_length;
+    }
 
-            i += 1;
-            source = branch(CHILD(n, i), source, target);
+    // Write from the final position to '\0'
+    memcpy(t, source + from, m->m_length - from);
+    t[m->m_length - from] = '\0';
 
-            // Close `).___some_op___(`.
-#ifndef NDEBUG
-    printf("printing ')' to target\n");
+    return result;
+}
+
+// Hand back the edits themselves, in one block: the list, then the text
+// to insert.  Edits that follow on from each other become one.
+static magicate_editlist *emitedits(magicator *m)
+{
+    magicate_editlist *list;
+    magicate_edit *ed = NULL;
+    unsigned char *t;
+    const edit *e;
+    size_t i, j, k, n, text;
+
+    n = m->m_edits.el_n + m->m_opens.el_n;
+    text = 0;
+    i = j = 0;
+    while ((e = nextedit(m, &i, &j)) != NULL)
+        text += e->e_width * e->e_count;
+    list = malloc(sizeof(magicate_editlist) +
+                  (n ? n - 1 : 0) * sizeof(magicate_edit) + text);
+    if (list == NULL)
+        return NULL;
+    t = (unsigned char *)&list->mel_edit[n ? n : 1];
+
+    list->mel_n = 0;
+    i = j = 0;
+    while ((e = nextedit(m, &i, &j)) != NULL) {
+        if (ed == NULL || e->e_offset != ed->ed_offset + ed->ed_delete) {
+            ed = &list->mel_edit[list->mel_n++];
+            ed->ed_offset = e->e_offset;
+            ed->ed_delete = 0;
+            ed->ed_insert = t;
+            ed->ed_insert_length = 0;
+        }
+        ed->ed_delete += e->e_length;
+        for (k = 0; k < e->e_count; ++k) {
+            memcpy(t, e->e_text, e->e_width);
+            t += e->e_width;
+        }
+        ed->ed_insert_length += e->e_width * e->e_count;
+    }
+    return list;
+}
+
+/*
+ * Most sources have no extra ops, and most of the rest only a few, so
+ * rather than parse a whole source, magicate looks for the ops first.  If
+ * there are none, the source is the result.  Otherwise a quick scan for
+ * brackets, backslashes, strings and comments finds the logical lines with
+ * ops in their code, and just those are parsed, each alone as a statement.
+ * The rest of the source is only copied.  Should a line not parse alone,
+ * or the lines make up much of the source, the whole source is parsed, so
+ * the result doesn't change, except that syntax errors away from the ops
+ * go unnoticed.
+ */
+
+// The three bytes of UTF-8 an extra op begins with
+#define ISOP(p) ((p)[0] == 0xe2 && (p)[1] == 0x8a && \
+                 ((p)[2] == 0x95 || (p)[2] == 0x97))
+
+// Return the first extra op at or after `p`, in code or not, or `end`.
+static const unsigned char *findop(const unsigned char *p,
+                                   const unsigned char *end)
+{
+#if defined(__AVX2__)
+    {
+        const __m256i lead = _mm256_set1_epi8((char)0xe2);
+        const __m256i second = _mm256_set1_epi8((char)0x8a);
+        const __m256i plus = _mm256_set1_epi8((char)0x95);
+        const __m256i times = _mm256_set1_epi8((char)0x97);
+
+        // An op's later bytes line up in the loads from p + 1 and p + 2
+        while (end - p >= 34) {
+            __m256i v0 = _mm256_loadu_si256((const __m256i *)p);
+            __m256i v1 = _mm256_loadu_si256((const __m256i *)(p + 1));
+            __m256i v2 = _mm256_loadu_si256((const __m256i *)(p + 2));
+            __m256i hit = _mm256_and_si256(
+                _mm256_and_si256(_mm256_cmpeq_epi8(v0, lead),
+                                 _mm256_cmpeq_epi8(v1, second)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v2, plus),
+                                _mm256_cmpeq_epi8(v2, times)));
+            unsigned int mask = (unsigned int)_mm256_movemask_epi8(hit);
+
+            if (mask != 0)
+                return p + __builtin_ctz(mask);
+            p += 32;
+        }
+    }
 #endif
-            **target = ')';
-            *target += 1;
+#if defined(__AVX2__) || defined(__SSE2__)
+    {
+        const __m128i lead = _mm_set1_epi8((char)0xe2);
+        const __m128i second = _mm_set1_epi8((char)0x8a);
+        const __m128i plus = _mm_set1_epi8((char)0x95);
+        const __m128i times = _mm_set1_epi8((char)0x97);
+
+        while (end - p >= 18) {
+            __m128i v0 = _mm_loadu_si128((const __m128i *)p);
+            __m128i v1 = _mm_loadu_si128((const __m128i *)(p + 1));
+            __m128i v2 = _mm_loadu_si128((const __m128i *)(p + 2));
+            __m128i hit = _mm_and_si128(
+                _mm_and_si128(_mm_cmpeq_epi8(v0, lead),
+                              _mm_cmpeq_epi8(v1, second)),
+                _mm_or_si128(_mm_cmpeq_epi8(v2, plus),
+                             _mm_cmpeq_epi8(v2, times)));
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(hit);
+
+            if (mask != 0)
+                return p + __builtin_ctz(mask);
+            p += 16;
         }
-        break;
-    default:
-        for (i=0; i<NCH(n); ++i) {
-            source = branch(CHILD(n, i), source, target);
+    }
+#endif
+    for (; end - p >= 3; p++)
+        if (ISOP(p))
+            return p;
+    return end;
+}
+
+// What the scan for logical lines makes of each byte
+enum {
+    B_CODE, B_BLANK, B_NEWLINE, B_COMMENT, B_QUOTE, B_BACKSLASH, B_OPEN,
+    B_CLOSE, B_LEAD
+};
+
+static const unsigned char byteclass[256] = {
+    [' '] = B_BLANK, ['\t'] = B_BLANK, ['\f'] = B_BLANK,
+    ['\n'] = B_NEWLINE,
+    ['#'] = B_COMMENT,
+    ['\''] = B_QUOTE, ['"'] = B_QUOTE,
+    ['\\'] = B_BACKSLASH,
+    ['('] = B_OPEN, ['['] = B_OPEN, ['{'] = B_OPEN,
+    [')'] = B_CLOSE, [']'] = B_CLOSE, ['}'] = B_CLOSE,
+    [0xe2] = B_LEAD
+};
+
+// Return the end of the string whose opening quote is at `p`.  A string
+// left open ends at the end of its line, or the source's, as its token does.
+static const unsigned char *skipstring(const unsigned char *p,
+                                       const unsigned char *end)
+{
+    unsigned char quote = *p;
+
+    if (end - p >= 3 && p[1] == quote && p[2] == quote) {
+        for (p += 3; p < end; p++) {
+            if (*p == '\\' && p + 1 < end)
+                p++;
+            else if (*p == quote && end - p >= 3 &&
+                     p[1] == quote && p[2] == quote)
+                return p + 3;
         }
+        return end;
+    }
+    for (p++; p < end; p++) {
+        if (*p == '\\' && p + 1 < end)
+            p++;
+        else if (*p == quote)
+            return p + 1;
+        else if (*p == '\n')
+            return p;
     }
+    return end;
+}
 
-    return source;
+static int addregion(magicator *m, const unsigned char *start,
+                     const unsigned char *last, const unsigned char *stop,
+                     const unsigned char *prev)
+{
+    region *r;
+
+    if (m->m_nregions == m->m_regionsize) {
+        size_t n = m->m_regionsize ? 2 * m->m_regionsize : 16;
+
+        r = PyMem_REALLOC(m->m_region, n * sizeof(region));
+        if (r == NULL)
+            return E_NOMEM;
+        m->m_region = r;
+        m->m_regionsize = n;
+    }
+    r = &m->m_region[m->m_nregions++];
+    r->r_start = start - m->m_source;
+    r->r_end = last + 1 - m->m_source;
+    r->r_stop = stop - m->m_source;
+    r->r_prev = prev != NULL ? prev + 1 - m->m_source : 0;
+    return 0;
 }
 
-unsigned int compute_delta(const node *n)
+// Find the logical lines with extra ops in their code.  Returns 0, or
+// E_NOMEM.
+static int findlines(magicator *m)
 {
-    int i;
-    unsigned int delta;
+    const unsigned char *p = m->m_source, *end = p + m->m_length;
+    const unsigned char *start = NULL;  // The line's first byte of code
+    const unsigned char *last = NULL;   // Its last so far
+    const unsigned char *prev = NULL;   // The last before the line
+    int depth = 0;                      // Brackets open
+    int hasop = 0;
+
+    while (p < end) {
+        const unsigned char *code = p;
 
-    if (ISEXTRAOP(TYPE(n))) {
-        // Close the prior and following groups => extra two parens.
-      delta = 2 + strlen((const char *)_Magicate_Magic[TYPE(n) - EXTRA_OP_OFFSET]) - STRL(n);
+        switch (byteclass[*p]) {
+        case B_BLANK:
+            p++;
+            continue;
+        case B_COMMENT:
+            p = memchr(p, '\n', end - p);
+            if (p == NULL)
+                p = end;
+            continue;
+        case B_NEWLINE:
+            p++;
+            if (depth == 0 && start != NULL) {
+                if (hasop && addregion(m, start, last, p, prev))
+                    return E_NOMEM;
+                prev = last;
+                start = NULL;
+                hasop = 0;
+            }
+            continue;
+        case B_BACKSLASH:
+            if (end - p >= 2 && p[1] == '\n') {
+                p += 2;
+                continue;
+            }
+            p++;
+            break;
+        case B_QUOTE:
+            p = skipstring(p, end);
+            break;
+        case B_OPEN:
+            depth++;
+            p++;
+            break;
+        case B_CLOSE:
+            if (depth > 0)
+                depth--;
+            p++;
+            break;
+        case B_LEAD:
+            if (end - p >= 3 && ISOP(p))
+                hasop = 1;
+            p++;
+            break;
+        default:
+            do
+                p++;
+            while (p < end && byteclass[*p] == B_CODE);
+            break;
+        }
+        if (start == NULL)
+            start = code;
+        last = p - 1;
     }
-    else {
-        delta = 0;
+    if (start != NULL && hasop && addregion(m, start, last, end, prev))
+        return E_NOMEM;
+    return 0;
+}
+
+// Whether the line at `p` begins with the keyword `kw`
+static int haskeyword(const unsigned char *p, const char *kw)
+{
+    size_t n = strlen(kw);
+
+    return memcmp(p, kw, n) == 0 &&
+        !(isalnum(p[n]) || p[n] == '_' || p[n] >= 0x80);
+}
+
+static const parser_callbacks callbacks = { on_push, on_shift, on_pop };
+
+// Parse the logical line `r` alone.  A line that isn't a statement by
+// itself gets what it needs to be one around it: a body for a compound
+// statement's header (in place of any comment), something to decorate for
+// a decorator, and a statement to go on for a clause like `else`.
+// Returns 0, or -1 if it doesn't parse.
+static int parseline(magicator *m, const region *r)
+{
+    grammar *g = &_PyParser_Grammar;
+    const unsigned char *line = m->m_source + r->r_start;
+    const char *prefix = "", *suffix = "";
+    size_t stop = r->r_stop, np, nl, ns;
+    perrdetail err;
+
+    if (m->m_source[r->r_end - 1] == ':') {
+        stop = r->r_end;
+        suffix = " pass\n";
     }
+    else if (line[0] == '@')
+        suffix = "\ndef f(): pass\n";
+    if (haskeyword(line, "elif") || haskeyword(line, "else"))
+        prefix = "if 1: pass\n";
+    else if (haskeyword(line, "except") || haskeyword(line, "finally"))
+        prefix = "try: pass\n";
+
+    np = strlen(prefix);
+    nl = stop - r->r_start;
+    ns = strlen(suffix);
+    if (np + nl + ns + 1 > m->m_bufsize) {
+        unsigned char *buf = PyMem_REALLOC(m->m_buf, np + nl + ns + 1);
 
-    for (i=0; i<NCH(n); ++i) {
-        delta += compute_delta(CHILD(n, i));
+        if (buf == NULL)
+            return -1;
+        m->m_buf = buf;
+        m->m_bufsize = np + nl + ns + 1;
     }
+    memcpy(m->m_buf, prefix, np);
+    memcpy(m->m_buf + np, line, nl);
+    memcpy(m->m_buf + np + nl, suffix, ns + 1);
 
-    return delta;
+    m->m_text = m->m_buf + np;
+    m->m_start = r->r_start;
+    m->m_stop = stop;
+    m->m_end = r->r_prev;
+    return PyParser_ParseStringCallbacks(m->m_buf, g, g->g_start, &callbacks,
+                                         m, &err) == E_DONE ? 0 : -1;
 }
 
-unsigned char *magicate(const unsigned char *source)
+// Parse the lines found, if that's worth it.  Returns 0, or -1 if the
+// whole source needs parsing.
+static int parselines(magicator *m)
+{
+    size_t i, total = 0;
+
+    for (i = 0; i < m->m_nregions; i++)
+        total += m->m_region[i].r_stop - m->m_region[i].r_start;
+    if (total > m->m_length / 2)
+        return -1;
+    for (i = 0; i < m->m_nregions; i++)
+        if (parseline(m, &m->m_region[i]) < 0)
+            return -1;
+    return 0;
+}
+
+// Run the rewrite over `source`, leaving its edits in *m.  Returns 0, or -1
+// if the source doesn't parse.
+static int run(magicator *m, const unsigned char *source)
 {
-    unsigned char **accumulator;
-    unsigned char *result, *t;
-    size_t length;
     grammar *g = &_PyParser_Grammar;
     perrdetail err;
-    node *n = PyParser_ParseString(source, g, g->g_start, &err);
 
-    length = strlen((const char *)source) + compute_delta(n);
-    t = result = malloc(length+1);
-    accumulator = &t;
-    result[length] = '\0';
+    memset(m, 0, sizeof(*m));
+    m->m_source = source;
+    m->m_length = strlen((const char *)source);
 
-    source = branch(n, source, accumulator);
+    if (findop(source, source + m->m_length) == source + m->m_length)
+        return 0;
 
-    // Write from the final position to '\0'
-    length = strlen((const char *)source);
-    memcpy(t, source, length);
+    if (findlines(m) != 0 || parselines(m) != 0) {
+        // Start again, on the whole source
+        m->m_edits.el_n = m->m_edits.el_growth = 0;
+        m->m_opens.el_n = m->m_opens.el_growth = 0;
+        m->m_nframes = 0;
+        m->m_depth = 0;
+        m->m_text = source;
+        m->m_start = 0;
+        m->m_stop = m->m_length;
+        m->m_end = 0;
+        if (PyParser_ParseStringCallbacks(source, g, g->g_start, &callbacks,
+                                          m, &err) != E_DONE)
+            return -1;
+    }
+
+    if (m->m_opens.el_n > 1)
+        qsort(m->m_opens.el_edit, m->m_opens.el_n, sizeof(edit),
+              compare_offsets);
+    return 0;
+}
+
+static void clear(magicator *m)
+{
+    PyMem_FREE(m->m_frame);
+    PyMem_FREE(m->m_edits.el_edit);
+    PyMem_FREE(m->m_opens.el_edit);
+    PyMem_FREE(m->m_region);
+    PyMem_FREE(m->m_buf);
+}
+
+// TODO: Validate AugAssign LHS, currently this produces code that runs under
+// Python contrary to proper AugAssign operators.
+unsigned char *magicate(const unsigned char *source)
+{
+    magicator m;
+    unsigned char *result = NULL;
+
+    // NULL if the source doesn't parse, at least where it has extra ops
+    if (run(&m, source) == 0)
+        result = emit(&m);
+    clear(&m);
+    return result;
+}
+
+magicate_editlist *magicate_edits(const unsigned char *source)
+{
+    magicator m;
+    magicate_editlist *result = NULL;
 
+    if (run(&m, source) == 0)
+        result = emitedits(&m);
+    clear(&m);
     return result;
 }
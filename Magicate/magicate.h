@@ -5,4 +5,30 @@
 
 extern void Py_FatalError(const char *msg);
 
+/* The rewritten source, or NULL if the source doesn't parse.  Only the
+   logical lines with operators to rewrite need to, so a syntax error
+   elsewhere may go unnoticed; a source without the operators comes back
+   as it is.  Free it with free(). */
+extern unsigned char *magicate(const unsigned char *source);
+
+/* Instead of the rewritten source, what to change in the source to get it:
+   at byte ed_offset, delete ed_delete bytes and insert ed_insert.  The
+   edits are in order of offset and don't overlap; their text follows them
+   in the same block, so that the list takes space for the operators only,
+   whatever the size of the source.  NULL if the source doesn't parse, as
+   for magicate().  Free it with free(). */
+typedef struct {
+    size_t ed_offset;
+    size_t ed_delete;
+    const unsigned char *ed_insert;
+    size_t ed_insert_length;
+} magicate_edit;
+
+typedef struct {
+    size_t mel_n;
+    magicate_edit mel_edit[1];  // Really mel_n of them
+} magicate_editlist;
+
+extern magicate_editlist *magicate_edits(const unsigned char *source);
+
 #endif
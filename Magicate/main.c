@@ -1,7 +1,5 @@
 #include "magicate.h"
 
-extern unsigned char *magicate(const unsigned char *source);
-
 void
 Py_Exit(int sts)
 {
@@ -21,14 +19,15 @@ main(int argc, char **argv)
     FILE *fp;
     long len;
     char *filename;
-    unsigned char *file, *p;
+    unsigned char *file, *p, *image;
+    int edits = argc == 3 && strcmp(argv[1], "-e") == 0;
 
-    if (argc != 2) {
+    if (argc != 2 + edits) {
         fprintf(stderr,
-            "usage: %s x.py\n", argv[0]);
+            "usage: %s [-e] x.py\n", argv[0]);
         Py_Exit(2);
     }
-    filename = argv[1];
+    filename = argv[1 + edits];
     fp = fopen(filename, "r");
     if (fp == NULL) {
         perror(filename);
@@ -51,7 +50,31 @@ main(int argc, char **argv)
 
     printf("Preimage:\n%s\n", file);
 
-    printf("Image:\n%s\n", magicate(file));
+    if (edits) {
+        magicate_editlist *list = magicate_edits(file);
+        size_t i;
+
+        if (list == NULL) {
+            fprintf(stderr, "%s: syntax error\n", filename);
+            Py_Exit(1);
+        }
+        printf("Edits:\n");
+        for (i = 0; i < list->mel_n; i++) {
+            magicate_edit *ed = &list->mel_edit[i];
+            printf("%lu -%lu +%.*s\n", (unsigned long)ed->ed_offset,
+                   (unsigned long)ed->ed_delete, (int)ed->ed_insert_length,
+                   ed->ed_insert);
+        }
+        free(list);
+        Py_Exit(0);
+    }
+
+    image = magicate(file);
+    if (image == NULL) {
+        fprintf(stderr, "%s: syntax error\n", filename);
+        Py_Exit(1);
+    }
+    printf("Image:\n%s\n", image);
 
     Py_Exit(0);
     return 0; /* Make gcc -Wall happy */
@@ -6,9 +6,14 @@
    of a DFA based upon a token, turning a search through an array
    into a simple indexing operation.  The parser now cannot work
    without the accelerators installed.  Note that the accelerators
-   are installed dynamically when the parser is initialized, they
-   are not part of the static data structure written on graminit.[ch]
-   by the parser generator. */
+   are computed by the parser generator and written on graminit.c as
+   constant data; only grammars built at run time, like pgen's own
+   meta-grammar, have them installed when the parser is initialized.
+
+   Each state's row of actions, indexed by label, is mostly empty, so the
+   rows are packed into one table by row displacement: a row goes at the
+   first offset where its entries land on free slots, and entries record
+   their row's offset so the parser can tell them apart. */
 
 #include "pgenheaders.h"
 #include "grammar.h"
@@ -17,21 +22,90 @@
 #include "token.h"
 #include "parser.h"
 
+/* The table under construction */
+typedef struct {
+    accel	*t_accel;	/* Entries */
+    char	*t_used;	/* Nonzero for offsets taken by a row */
+    int		 t_size;	/* Allocated entries */
+    int		 t_free;	/* No free entries below this */
+    state	**t_rows;	/* States placed so far, for sharing */
+    int		 t_nrows;
+} acceltab;
+
 /* Forward references */
-static void fixdfa(grammar *, dfa *);
-static void fixstate(grammar *, state *);
+static void fixdfa(grammar *, dfa *, acceltab *, accel *);
+static void fixstate(grammar *, state *, acceltab *, accel *);
+static void fixlabels(grammar *);
+
+static void
+nomem(void)
+{
+    fprintf(stderr, "no mem to build parser accelerators\n");
+    exit(1);
+}
+
+/* The grammar has more of `what` than an accel entry can hold */
+static void
+toobig(const char *what, int n, int max)
+{
+    fprintf(stderr, "grammar too big for parser accelerators: "
+            "%s %d exceeds %d\n", what, n, max);
+    exit(1);
+}
 
 void
 PyGrammar_AddAccelerators(grammar *g)
 {
     dfa *d;
     int i;
+    acceltab t;
+    accel *row;
+    size_t size = g->g_ll.ll_nlabels * (sizeof(accel) + sizeof(int));
+
+    /* A scratch row, followed by room for its list of labels */
+    row = (accel *) PyMem_MALLOC(size);
+    if (row == NULL)
+        nomem();
+    t.t_accel = NULL;
+    t.t_used = NULL;
+    t.t_size = 0;
+    t.t_free = 0;
+    t.t_nrows = 0;
+    size = sizeof(state *);
+    for (i = 0; i < g->g_ndfas; i++)
+        size += g->g_dfa[i].d_nstates * sizeof(state *);
+    t.t_rows = (state **) PyMem_MALLOC(size);
+    if (t.t_rows == NULL)
+        nomem();
     d = g->g_dfa;
     for (i = g->g_ndfas; --i >= 0; d++)
-        fixdfa(g, d);
+        fixdfa(g, d, &t, row);
+    PyMem_FREE(row);
+    PyMem_FREE(t.t_used);
+    PyMem_FREE(t.t_rows);
+
+    /* Trim the table to the last entry any row can reach */
+    g->g_naccel = 0;
+    d = g->g_dfa;
+    for (i = g->g_ndfas; --i >= 0; d++) {
+        state *s = d->d_state;
+        int j;
+        for (j = 0; j < d->d_nstates; j++, s++)
+            if (s->s_upper > s->s_lower &&
+                s->s_accel + s->s_upper > g->g_naccel)
+                g->g_naccel = s->s_accel + s->s_upper;
+    }
+    size = (g->g_naccel > 0 ? g->g_naccel : 1) * sizeof(accel);
+    t.t_accel = (accel *) PyMem_REALLOC(t.t_accel, size);
+    if (t.t_accel == NULL)
+        nomem();
+    g->g_acceltab = t.t_accel;
+
+    fixlabels(g);
     g->g_accel = 1;
 }
 
+/* Only for accelerators added at run time, not those pgen wrote out */
 void
 PyGrammar_RemoveAccelerators(grammar *g)
 {
@@ -44,83 +118,242 @@ PyGrammar_RemoveAccelerators(grammar *g)
         int j;
         s = d->d_state;
         for (j = 0; j < d->d_nstates; j++, s++) {
-            if (s->s_accel)
-                PyMem_FREE(s->s_accel);
-            s->s_accel = NULL;
+            s->s_lower = 0;
+            s->s_upper = 0;
+            s->s_accel = 0;
         }
     }
+    PyMem_FREE((void *)g->g_acceltab);
+    g->g_acceltab = NULL;
+    g->g_naccel = 0;
+    PyMem_FREE((void *)g->g_toklabel);
+    g->g_toklabel = NULL;
+    PyMem_FREE((void *)g->g_kwlabel);
+    g->g_kwlabel = NULL;
 }
 
+/* Try to place every keyword label in a table of 1 << bits slots under
+   `seed` without collisions; returns 1 on success. */
+static int
+placekeywords(grammar *g, int *slots, int bits, unsigned int seed)
+{
+    label *l = g->g_ll.ll_label;
+    int nl = g->g_ll.ll_nlabels;
+    int k;
+
+    for (k = 0; k < 1 << bits; k++)
+        slots[k] = -1;
+    for (k = 0; k < nl; k++) {
+        unsigned int slot;
+        if (l[k].lb_type != NAME || l[k].lb_str == NULL)
+            continue;
+        slot = (KW_KEY(l[k].lb_str, l[k].lb_str_length) * seed) >> (32 - bits);
+        if (slots[slot] != -1)
+            return 0;
+        slots[slot] = k;
+    }
+    return 1;
+}
+
+/* Build g_toklabel and the perfect keyword hash g_kwlabel */
 static void
-fixdfa(grammar *g, dfa *d)
+fixlabels(grammar *g)
+{
+    label *l = g->g_ll.ll_label;
+    int nl = g->g_ll.ll_nlabels;
+    int nkeywords = 0;
+    int bits, k, tries;
+    unsigned int seed;
+    int *toklabel, *kwlabel;
+    size_t size = N_TOKENS * sizeof(int);
+
+    toklabel = (int *) PyMem_MALLOC(size);
+    if (toklabel == NULL)
+        nomem();
+    for (k = 0; k < N_TOKENS; k++)
+        toklabel[k] = -1;
+    for (k = nl; --k >= 0; ) {
+        if (l[k].lb_str != NULL)
+            nkeywords += l[k].lb_type == NAME;
+        else if (ISTERMINAL(l[k].lb_type) && l[k].lb_type < N_TOKENS)
+            toklabel[l[k].lb_type] = k;
+    }
+    g->g_toklabel = toklabel;
+
+    /* Start at twice the keywords and double until some seed works */
+    for (bits = 1; 1 << bits < 2 * nkeywords; bits++)
+        ;
+    for (; bits <= 16; bits++) {
+        size = ((size_t)1 << bits) * sizeof(int);
+        kwlabel = (int *) PyMem_MALLOC(size);
+        if (kwlabel == NULL)
+            nomem();
+        for (seed = 0x9e3779b1u, tries = 0; tries < 1000; tries++) {
+            if (placekeywords(g, kwlabel, bits, seed)) {
+                g->g_kwlabel = kwlabel;
+                g->g_kwseed = seed;
+                g->g_kwshift = 32 - bits;
+                return;
+            }
+            seed = (seed * 1103515245u + 12345u) | 1u;
+        }
+        PyMem_FREE(kwlabel);
+    }
+    fprintf(stderr, "can't build the keyword hash\n");
+    exit(1);
+}
+
+static void
+fixdfa(grammar *g, dfa *d, acceltab *t, accel *row)
 {
     state *s;
     int j;
     s = d->d_state;
     for (j = 0; j < d->d_nstates; j++, s++)
-        fixstate(g, s);
+        fixstate(g, s, t, row);
 }
 
+/* Make room for entries up to `n` in the table */
 static void
-fixstate(grammar *g, state *s)
+growtab(acceltab *t, int n)
 {
-    arc *a;
+    int size = t->t_size;
+    size_t bytes;
     int k;
-    int *accel;
+
+    if (n <= size)
+        return;
+    if (size == 0)
+        size = 1024;
+    while (size < n) {
+        if (size > INT_MAX / 2)
+            nomem();
+        size *= 2;
+    }
+    bytes = size * sizeof(accel);
+    t->t_accel = (accel *) PyMem_REALLOC(t->t_accel, bytes);
+    t->t_used = (char *) PyMem_REALLOC(t->t_used, size);
+    if (t->t_accel == NULL || t->t_used == NULL)
+        nomem();
+    for (k = t->t_size; k < size; k++) {
+        t->t_accel[k].ac_check = -1;
+        t->t_used[k] = 0;
+    }
+    t->t_size = size;
+}
+
+/* Return the offset of an already placed row with the same entries as
+   `row`, or -1 */
+static int
+findrow(acceltab *t, accel *row, int lower, int upper, int *labels, int n)
+{
+    int i, k;
+
+    for (i = 0; i < t->t_nrows; i++) {
+        state *s = t->t_rows[i];
+        if (s->s_lower != lower || s->s_upper != upper)
+            continue;
+        for (k = 0; k < n; k++) {
+            accel *ac = &t->t_accel[s->s_accel + labels[k]];
+            if (ac->ac_check != s->s_accel ||
+                ac->ac_arrow != row[labels[k]].ac_arrow ||
+                ac->ac_push != row[labels[k]].ac_push)
+                break;
+        }
+        /* The placed row may have more entries than this one */
+        if (k == n) {
+            int m = 0;
+            for (k = lower; k < upper; k++)
+                m += t->t_accel[s->s_accel + k].ac_check == s->s_accel;
+            if (m == n)
+                return s->s_accel;
+        }
+    }
+    return -1;
+}
+
+/* Find the first free offset for the entries of `row` between `lower` and
+   `upper` and copy them there; returns the offset.  `labels` lists the
+   labels with entries, of which there are `n`. */
+static int
+placerow(acceltab *t, accel *row, int lower, int upper, int *labels, int n)
+{
+    int base, k;
+
+    while (t->t_free < t->t_size && t->t_accel[t->t_free].ac_check != -1)
+        t->t_free++;
+    base = t->t_free > lower ? t->t_free - lower : 0;
+    for (;; base++) {
+        growtab(t, base + upper);
+        if (t->t_used[base])
+            continue;
+        for (k = 0; k < n; k++)
+            if (t->t_accel[base + labels[k]].ac_check != -1)
+                break;
+        if (k == n)
+            break;
+    }
+    if (base > AC_MAXROW)
+        toobig("accelerator row", base, AC_MAXROW);
+    t->t_used[base] = 1;
+    for (k = 0; k < n; k++) {
+        t->t_accel[base + labels[k]] = row[labels[k]];
+        t->t_accel[base + labels[k]].ac_check = base;
+    }
+    return base;
+}
+
+static void
+fixstate(grammar *g, state *s, acceltab *t, accel *row)
+{
+    arc *a;
+    int k, n;
+    int *labels = (int *)(row + g->g_ll.ll_nlabels);
     int nl = g->g_ll.ll_nlabels;
     s->s_accept = 0;
-    accel = (int *) PyMem_MALLOC(nl * sizeof(int));
-    if (accel == NULL) {
-        fprintf(stderr, "no mem to build parser accelerators\n");
-        exit(1);
-    }
     for (k = 0; k < nl; k++)
-        accel[k] = -1;
+        row[k].ac_check = -1;
     a = s->s_arc;
     for (k = s->s_narcs; --k >= 0; a++) {
         int lbl = a->a_lbl;
         label *l = &g->g_ll.ll_label[lbl];
         int type = l->lb_type;
-        if (a->a_arrow >= (1 << 7)) {
-            printf("XXX too many states!\n");
-            continue;
-        }
+        if (a->a_arrow > AC_MAXARROW)
+            toobig("state", a->a_arrow, AC_MAXARROW);
         if (ISNONTERMINAL(type)) {
             dfa *d1 = PyGrammar_FindDFA(g, type);
             int ibit;
-            if (type - NT_OFFSET >= (1 << 7)) {
-                printf("XXX too high nonterminal number!\n");
-                continue;
-            }
+            if (type - NT_OFFSET > AC_MAXPUSH)
+                toobig("nonterminal", type - NT_OFFSET, AC_MAXPUSH);
             for (ibit = 0; ibit < g->g_ll.ll_nlabels; ibit++) {
                 if (testbit(d1->d_first, ibit)) {
-                    if (accel[ibit] != -1)
+                    if (row[ibit].ac_check != -1)
                         printf("XXX ambiguity!\n");
-                    accel[ibit] = a->a_arrow | (1 << 7) |
-                        ((type - NT_OFFSET) << 8);
+                    row[ibit].ac_check = 0;
+                    row[ibit].ac_arrow = a->a_arrow;
+                    row[ibit].ac_push = type - NT_OFFSET;
                 }
             }
         }
         else if (lbl == EMPTY)
             s->s_accept = 1;
-        else if (lbl >= 0 && lbl < nl)
-            accel[lbl] = a->a_arrow;
+        else if (lbl >= 0 && lbl < nl) {
+            row[lbl].ac_check = 0;
+            row[lbl].ac_arrow = a->a_arrow;
+            row[lbl].ac_push = -1;
+        }
     }
-    while (nl > 0 && accel[nl-1] == -1)
-        nl--;
-    for (k = 0; k < nl && accel[k] == -1;)
-        k++;
-    if (k < nl) {
-        int i;
-        s->s_accel = (int *) PyMem_MALLOC((nl-k) * sizeof(int));
-        if (s->s_accel == NULL) {
-            fprintf(stderr, "no mem to add parser accelerators\n");
-            exit(1);
+    for (k = 0, n = 0; k < nl; k++)
+        if (row[k].ac_check != -1)
+            labels[n++] = k;
+    if (n > 0) {
+        s->s_lower = labels[0];
+        s->s_upper = labels[n-1] + 1;
+        /* Identical rows can share their entries */
+        s->s_accel = findrow(t, row, s->s_lower, s->s_upper, labels, n);
+        if (s->s_accel < 0) {
+            s->s_accel = placerow(t, row, s->s_lower, s->s_upper, labels, n);
+            t->t_rows[t->t_nrows++] = s;
         }
-        s->s_lower = k;
-        s->s_upper = nl;
-        for (i = 0; k < nl; i++, k++)
-            s->s_accel[i] = accel[k];
     }
-    PyMem_FREE(accel);
 }
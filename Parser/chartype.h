@@ -0,0 +1,43 @@
+#ifndef Py_CHARTYPE_H
+#define Py_CHARTYPE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Character classes of code points, as seen by the tokenizer */
+
+/* The tables live in chartype.c, which is generated by makechartype.py
+   (`make regen-chartype`).  Keep these values in sync with that script. */
+
+#define CT_ID_START     0x01    /* PEP 3131 XID_Start, or '_' */
+#define CT_ID_CONTINUE  0x02    /* PEP 3131 XID_Continue */
+#define CT_DIGIT        0x04    /* 0-9 */
+#define CT_XDIGIT       0x08    /* 0-9, a-f, A-F */
+#define CT_SPACE        0x10    /* Blanks between tokens: ' ', '\t', '\014' */
+
+#define CT_SHIFT        4       /* log2 of the BMP table's block size */
+
+extern const unsigned char _PyChar_ASCII[128];
+extern const unsigned char _PyChar_Index1[];
+extern const unsigned char _PyChar_Index2[];
+unsigned int _PyChar_AstralType(unsigned int c);
+
+/* ASCII with one load, the rest of the BMP with two, then a binary search
+   for the rare code points beyond it.  EOF maps to no class at all. */
+#define Py_CHARTYPE(c)                                                  \
+    ((c) < 0x80 ? _PyChar_ASCII[(c)] :                                  \
+     (c) < 0x10000 ?                                                    \
+         _PyChar_Index2[(_PyChar_Index1[(c) >> CT_SHIFT] << CT_SHIFT) + \
+                        ((c) & ((1 << CT_SHIFT) - 1))] :                \
+     _PyChar_AstralType(c))
+
+#define Py_ISIDSTART(c)     (Py_CHARTYPE(c) & CT_ID_START)
+#define Py_ISIDCONTINUE(c)  (Py_CHARTYPE(c) & CT_ID_CONTINUE)
+#define Py_ISDIGIT(c)       (Py_CHARTYPE(c) & CT_DIGIT)
+#define Py_ISXDIGIT(c)      (Py_CHARTYPE(c) & CT_XDIGIT)
+#define Py_ISBLANK(c)       (Py_CHARTYPE(c) & CT_SPACE)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !Py_CHARTYPE_H */
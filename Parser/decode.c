@@ -2,6 +2,12 @@
 
 #include "Python.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 // Copyright (c) 2008-2009 Bjoern Hoehrmann <bjoern@hoehrmann.de>
 // See http://bjoern.hoehrmann.de/utf-8/decoder/dfa/ for details.
 
@@ -41,9 +47,127 @@ const unsigned char *
 decode(const unsigned char *start, unsigned int *target) {
     unsigned int state=0;
     const unsigned char * p=start;
+
+    if (*p < 0x80) {
+        *target = *p;
+        return p + 1;
+    }
+
     *target = 0;
     while (_decode(&state, target, *p++) > utf8_reject);
     if (state == utf8_reject) return start;
 
     return p;
 }
+
+/*
+ * Return a pointer to the first byte in [`p`, `end`) that isn't ASCII, or
+ * `end` if there is no such byte.  Bytes within the run decode to themselves,
+ * so the tokenizer hands them out without consulting the DFA above.
+ */
+const unsigned char *
+ascii_run(const unsigned char *p, const unsigned char *end)
+{
+#if defined(__AVX2__)
+    while (end - p >= 32) {
+        int mask = _mm256_movemask_epi8(
+            _mm256_loadu_si256((const __m256i *)p));
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+        p += 32;
+    }
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+    while (end - p >= 16) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)p));
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#else
+    {
+        /* Scalar fallback (Emscripten, et al.), a word at a time. */
+        const size_t high = ((size_t)-1 / 0xff) * 0x80;
+        size_t word;
+        while ((size_t)(end - p) >= sizeof(size_t)) {
+            memcpy(&word, p, sizeof(size_t));
+            if (word & high)
+                break;
+            p += sizeof(size_t);
+        }
+    }
+#endif
+    while (p != end && *p < 0x80)
+        p++;
+    return p;
+}
+
+/*
+ * Return a pointer to the first occurrence of byte `a` or byte `b` in [`p`,
+ * `end`), or `end` if neither occurs.  Both are ASCII, so the scan can hop
+ * over multibyte sequences without decoding them.
+ */
+const unsigned char *
+memchr2(const unsigned char *p, const unsigned char *end, int a, int b)
+{
+#if defined(__AVX2__)
+    {
+        const __m256i va = _mm256_set1_epi8((char)a);
+        const __m256i vb = _mm256_set1_epi8((char)b);
+        while (end - p >= 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)p);
+            int mask = _mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, va),
+                                _mm256_cmpeq_epi8(v, vb)));
+            if (mask != 0)
+                return p + __builtin_ctz(mask);
+            p += 32;
+        }
+    }
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+    {
+        const __m128i va = _mm_set1_epi8((char)a);
+        const __m128i vb = _mm_set1_epi8((char)b);
+        while (end - p >= 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)p);
+            int mask = _mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)));
+            if (mask != 0)
+                return p + __builtin_ctz(mask);
+            p += 16;
+        }
+    }
+#endif
+    while (p != end && *p != a && *p != b)
+        p++;
+    return p;
+}
+
+/*
+ * Check that [`p`, `end`) is well-formed UTF-8.  Return NULL if it is,
+ * otherwise a pointer to the first byte of the first invalid (or truncated)
+ * sequence.  ASCII runs are skipped with `ascii_run`, so only the non-ASCII
+ * sequences ever see the DFA.
+ */
+const unsigned char *
+validate(const unsigned char *p, const unsigned char *end)
+{
+    unsigned int state, codep;
+    const unsigned char *start;
+
+    for (;;) {
+        p = ascii_run(p, end);
+        if (p == end)
+            return NULL;
+
+        start = p;
+        state = utf8_accept;
+        do {
+            if (p == end)
+                return start;
+        } while (_decode(&state, &codep, *p++) > utf8_reject);
+        if (state == utf8_reject)
+            return start;
+    }
+}
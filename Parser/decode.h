@@ -2,5 +2,8 @@
 #define DECODE_H
 
 const unsigned char *decode(const unsigned char *, unsigned int *);
+const unsigned char *ascii_run(const unsigned char *, const unsigned char *);
+const unsigned char *memchr2(const unsigned char *, const unsigned char *, int, int);
+const unsigned char *validate(const unsigned char *, const unsigned char *);
 
 #endif
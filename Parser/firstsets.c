@@ -7,13 +7,14 @@
 #include "token.h"
 
 /* Forward */
-static void calcfirstset(grammar *, dfa *);
+static void calcfirstset(grammar *, dfa *, bitset);
 
 void
 addfirstsets(grammar *g)
 {
     int i;
     dfa *d;
+    bitset dummy = newbitset(1); /* Marks a FIRST set being calculated */
 
 #ifndef NDEBUG
     printf("Adding FIRST sets ...\n");
@@ -21,12 +22,13 @@ addfirstsets(grammar *g)
     for (i = 0; i < g->g_ndfas; i++) {
         d = &g->g_dfa[i];
         if (d->d_first == NULL)
-            calcfirstset(g, d);
+            calcfirstset(g, d, dummy);
     }
+    delbitset(dummy);
 }
 
 static void
-calcfirstset(grammar *g, dfa *d)
+calcfirstset(grammar *g, dfa *d, bitset dummy)
 {
     int i, j;
     state *s;
@@ -34,7 +36,6 @@ calcfirstset(grammar *g, dfa *d)
     int nsyms;
     int *sym;
     int nbits;
-    static bitset dummy;
     bitset result;
     int type;
     dfa *d1;
@@ -45,8 +46,6 @@ calcfirstset(grammar *g, dfa *d)
            (int)d->d_name_length, d->d_name);
 #endif
 
-    if (dummy == NULL)
-        dummy = newbitset(1);
     if (d->d_first == dummy) {
         fprintf(stderr, "Left-recursion for '%.*s'\n",
                 (int)d->d_name_length, d->d_name);
@@ -91,7 +90,7 @@ calcfirstset(grammar *g, dfa *d)
                 }
                 else {
                     if (d1->d_first == NULL)
-                        calcfirstset(g, d1);
+                        calcfirstset(g, d1, dummy);
                     mergebitset(result,
                                 d1->d_first, nbits);
                 }
@@ -8,14 +8,11 @@
 
 #include "token.h"
 #include "grammar.h"
-#include "decode.h"
 
 #ifdef RISCOS
 #include <unixlib.h>
 #endif
 
-static const size_t maximum_string_length=20;
-
 grammar *
 newgrammar(int start)
 {
@@ -30,6 +27,10 @@ newgrammar(int start)
     g->g_ll.ll_nlabels = 0;
     g->g_ll.ll_label = NULL;
     g->g_accel = 0;
+    g->g_naccel = 0;
+    g->g_acceltab = NULL;
+    g->g_toklabel = NULL;
+    g->g_kwlabel = NULL;
     return g;
 }
 
@@ -69,7 +70,7 @@ addstate(dfa *d)
     s->s_arc = NULL;
     s->s_lower = 0;
     s->s_upper = 0;
-    s->s_accel = NULL;
+    s->s_accel = 0;
     s->s_accept = 0;
     return s - d->d_state;
 }
@@ -206,65 +207,19 @@ translabel(grammar *g, label *lb)
                 lb->lb_str_length = p - lb->lb_str;
         }
         else {
-            int type;
-            unsigned int *utf;
-
-            // Limit strings to `maximum_string_length` (+2 quotes).
-            unsigned int utf_data[maximum_string_length+2];
-
-            // Decode the label and bracket it [`utf`, `utf_end`).
-            unsigned int *utf_end = &utf_data[0];
-            const unsigned char *i=lb->lb_str;
-            while (i - lb->lb_str < lb->lb_str_length) {
-                i = decode(i, utf_end++);
-
-                assert(utf_end - utf_data < maximum_string_length);
-            }
-
-            assert(utf_data[0] == (unsigned int)(unsigned char)'\'');
-
-            utf_end -= 1;
-            assert(*utf_end == (unsigned int)(unsigned char)'\'');
-
-            utf = &utf_data[1];
-            switch (utf_end - utf) {
-              /*
-               * Operators from the grammar are wrapped by single quotes, so I'm
-               * looking for the operator's length plus two.
-               */
-            case 1:
-                type = (int) PyToken_OneChar(utf[0]);
-                if (type != OP) {
-                    lb->lb_type = type;
-                    lb->lb_str = NULL;
-                    lb->lb_str_length = 0;
-                }
-                else printf("Unknown OP label %.*s\n",
-                            (int)lb->lb_str_length, (const char *)lb->lb_str);
-                break;
-            case 2:
-                type = (int) PyToken_TwoChars(utf[0], utf[1]);
-                if (type != OP) {
-                    lb->lb_type = type;
-                    lb->lb_str = NULL;
-                    lb->lb_str_length = 0;
-                }
-                else printf("Unknown OP label %.*s\n",
-                            (int)lb->lb_str_length, (const char *)lb->lb_str);
-                break;
-            case 3:
-                type = (int) PyToken_ThreeChars(utf[0], utf[1], utf[2]);
-                if (type != OP) {
-                    lb->lb_type = type;
-                    lb->lb_str = NULL;
-                    lb->lb_str_length = 0;
-                }
-                else printf("Unknown OP label %.*s\n",
-                            (int)lb->lb_str_length, (const char *)lb->lb_str);
-                break;
-            default: printf("Can't translate STRING label %.*s\n",
-                            (int)lb->lb_str_length, (const char*)lb->lb_str);
+            /* Operators from the grammar are wrapped by single quotes */
+            const unsigned char *op = lb->lb_str + 1;
+            size_t length = lb->lb_str_length - 2;
+            int type = OP;
+
+            if (length > 0 &&
+                (size_t)PyToken_Match(op, op + length, &type) == length) {
+                lb->lb_type = type;
+                lb->lb_str = NULL;
+                lb->lb_str_length = 0;
             }
+            else printf("Unknown OP label %.*s\n",
+                        (int)lb->lb_str_length, (const char *)lb->lb_str);
         }
     }
     else
@@ -0,0 +1,271 @@
+
+/* Line table implementation */
+
+/* One pass over the source finds every newline and notes which lines hold
+   any non-ASCII bytes.  Mapping an offset to its line is then a lookup in
+   lt_block followed by a step or two through lt_start, and columns on ASCII
+   lines (nearly all of them) are a subtraction whatever the unit.  Only
+   columns on non-ASCII lines need to look at the line's bytes. */
+
+#include "Python.h"
+#include "linetable.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Double the line arrays; returns 0, or -1 on no memory */
+static int
+grow(linetable *lt, int *capacity)
+{
+    int n = *capacity * 2;
+    size_t size = sizeof(unsigned int) * n;
+    unsigned int *s;
+    unsigned char *a;
+
+    s = (unsigned int *)PyMem_REALLOC(lt->lt_start, size);
+    if (s == NULL)
+        return -1;
+    lt->lt_start = s;
+    a = (unsigned char *)PyMem_REALLOC(lt->lt_ascii, n);
+    if (a == NULL)
+        return -1;
+    lt->lt_ascii = a;
+    *capacity = n;
+    return 0;
+}
+
+/* Append a line starting at `start`; returns 0, or -1 on no memory */
+static inline int
+addline(linetable *lt, int *capacity, unsigned int start)
+{
+    if (lt->lt_nlines + 1 >= *capacity && grow(lt, capacity) < 0)
+        return -1;
+    lt->lt_start[lt->lt_nlines] = start;
+    lt->lt_ascii[lt->lt_nlines] = 1;
+    lt->lt_nlines++;
+    return 0;
+}
+
+/* Record the newlines (`nl`) and high bytes (`hi`) of a chunk at `base`,
+   given as bit masks. */
+static inline int
+addchunk(linetable *lt, int *capacity, unsigned int base,
+         unsigned int nl, unsigned int hi)
+{
+    while (nl != 0) {
+        int i = __builtin_ctz(nl);
+        if (hi != 0) {
+            unsigned int below = (1u << i) - 1;
+            if (hi & below)
+                lt->lt_ascii[lt->lt_nlines - 1] = 0;
+            hi &= ~below;
+        }
+        if (addline(lt, capacity, base + i + 1) < 0)
+            return -1;
+        nl &= nl - 1;
+    }
+    if (hi != 0)
+        lt->lt_ascii[lt->lt_nlines - 1] = 0;
+    return 0;
+}
+
+static int
+scan(linetable *lt, int *capacity)
+{
+    const unsigned char *str = lt->lt_str;
+    const unsigned char *p = str;
+    const unsigned char *end = str + lt->lt_length;
+
+#if defined(__AVX2__)
+    {
+        const __m256i newline = _mm256_set1_epi8('\n');
+        while (end - p >= 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)p);
+            unsigned int nl = (unsigned int)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(v, newline));
+            unsigned int hi = (unsigned int)_mm256_movemask_epi8(v);
+            if ((nl | hi) != 0 &&
+                addchunk(lt, capacity, p - str, nl, hi) < 0)
+                return -1;
+            p += 32;
+        }
+    }
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+    {
+        const __m128i newline = _mm_set1_epi8('\n');
+        while (end - p >= 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)p);
+            unsigned int nl = (unsigned int)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(v, newline));
+            unsigned int hi = (unsigned int)_mm_movemask_epi8(v);
+            if ((nl | hi) != 0 &&
+                addchunk(lt, capacity, p - str, nl, hi) < 0)
+                return -1;
+            p += 16;
+        }
+    }
+#endif
+    for (; p != end; p++) {
+        if (*p == '\n') {
+            if (addline(lt, capacity, p - str + 1) < 0)
+                return -1;
+        }
+        else if (*p >= 0x80)
+            lt->lt_ascii[lt->lt_nlines - 1] = 0;
+    }
+    return 0;
+}
+
+linetable *
+PyLineTable_New(const unsigned char *str, size_t length)
+{
+    linetable *lt;
+    int capacity;
+    size_t size, nblocks, b;
+    int l;
+
+    if (length >= UINT_MAX)
+        return NULL;
+
+    lt = (linetable *)PyMem_MALLOC(sizeof(linetable));
+    if (lt == NULL)
+        return NULL;
+    lt->lt_str = str;
+    lt->lt_length = (unsigned int)length;
+    lt->lt_nlines = 0;
+    lt->lt_block = NULL;
+
+    /* Guess at 32 bytes per line; addline grows the arrays as needed */
+    capacity = (int)(length / 32) + 16;
+    size = sizeof(unsigned int) * capacity;
+    lt->lt_start = (unsigned int *)PyMem_MALLOC(size);
+    lt->lt_ascii = (unsigned char *)PyMem_MALLOC(capacity);
+    if (lt->lt_start == NULL || lt->lt_ascii == NULL)
+        goto nomem;
+
+    if (addline(lt, &capacity, 0) < 0 || scan(lt, &capacity) < 0)
+        goto nomem;
+
+    /* The start recorded past a final newline (or for empty input) is no
+       line at all; it becomes the sentinel.  Otherwise add the sentinel. */
+    if (lt->lt_start[lt->lt_nlines - 1] == lt->lt_length)
+        lt->lt_nlines--;
+    else
+        lt->lt_start[lt->lt_nlines] = lt->lt_length;
+
+    nblocks = (length >> LT_BLOCK_SHIFT) + 1;
+    size = sizeof(int) * nblocks;
+    lt->lt_block = (int *)PyMem_MALLOC(size);
+    if (lt->lt_block == NULL)
+        goto nomem;
+    for (b = 0, l = 0; b < nblocks; b++) {
+        unsigned int offset = (unsigned int)(b << LT_BLOCK_SHIFT);
+        while (l + 1 < lt->lt_nlines && lt->lt_start[l + 1] <= offset)
+            l++;
+        lt->lt_block[b] = l;
+    }
+
+    return lt;
+
+  nomem:
+    PyLineTable_Free(lt);
+    return NULL;
+}
+
+void
+PyLineTable_Free(linetable *lt)
+{
+    if (lt == NULL)
+        return;
+    PyMem_FREE(lt->lt_start);
+    PyMem_FREE(lt->lt_ascii);
+    PyMem_FREE(lt->lt_block);
+    PyMem_FREE(lt);
+}
+
+/* Return the line holding `offset`; offsets up to and including
+   lt_length are valid, else -1. */
+int
+PyLineTable_Line(linetable *lt, size_t offset)
+{
+    int l;
+
+    if (offset > lt->lt_length)
+        return -1;
+    l = lt->lt_block[offset >> LT_BLOCK_SHIFT];
+    while (l + 1 < lt->lt_nlines && lt->lt_start[l + 1] <= offset)
+        l++;
+    return l + 1;
+}
+
+/* Return the column of `offset` within its line, counted in `unit`s */
+int
+PyLineTable_Column(linetable *lt, size_t offset, int unit)
+{
+    int line = PyLineTable_Line(lt, offset);
+    const unsigned char *p, *end;
+    int column;
+
+    if (line < 0)
+        return -1;
+    if (lt->lt_nlines == 0)
+        return 0;
+    p = lt->lt_str + LT_LINESTART(lt, line);
+    end = lt->lt_str + offset;
+    if (unit == LT_BYTES || LT_ISASCII(lt, line))
+        return (int)(end - p);
+
+    /* Count lead bytes; characters beyond the BMP take two UTF-16 units */
+    for (column = 0; p < end; p++) {
+        if ((*p & 0xc0) != 0x80)
+            column++;
+        if (unit == LT_UTF16 && *p >= 0xf0)
+            column++;
+    }
+    return column;
+}
+
+/* Return the offset of `column` (counted in `unit`s) on `line`, clamped to
+   the end of the line, or (size_t)-1 if there's no such line. */
+size_t
+PyLineTable_Offset(linetable *lt, int line, int column, int unit)
+{
+    const unsigned char *start, *p, *end;
+    int n;
+
+    if (line < 1 || line > lt->lt_nlines || column < 0)
+        return (size_t)-1;
+    start = lt->lt_str + LT_LINESTART(lt, line);
+    end = lt->lt_str + LT_LINEEND(lt, line);
+    if (unit == LT_BYTES || LT_ISASCII(lt, line)) {
+        if (column > end - start)
+            column = (int)(end - start);
+        return LT_LINESTART(lt, line) + column;
+    }
+
+    for (p = start, n = 0; p < end && n < column; ) {
+        if (*p >= 0xf0) {
+            p += 4;
+            n += unit == LT_UTF16 ? 2 : 1;
+        }
+        else if (*p >= 0xe0) {
+            p += 3;
+            n++;
+        }
+        else if (*p >= 0xc0) {
+            p += 2;
+            n++;
+        }
+        else {
+            p++;
+            n++;
+        }
+    }
+    if (p > end)
+        p = end;
+    return p - lt->lt_str;
+}
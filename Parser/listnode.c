@@ -5,8 +5,14 @@
 #include "token.h"
 #include "node.h"
 
+typedef struct {
+    FILE *fp;
+    int level;
+    int atbol;
+} lister;
+
 /* Forward */
-static void list1node(FILE *, node *);
+static int list1token(void *, node *);
 static void listnode(FILE *, node *);
 
 void
@@ -15,52 +21,50 @@ PyNode_ListTree(node *n)
     listnode(stdout, n);
 }
 
-static int level, atbol;
-
 static void
 listnode(FILE *fp, node *n)
 {
-    level = 0;
-    atbol = 1;
-    list1node(fp, n);
-}
+    static const nodevisitor v = {NULL, NULL, 0, list1token};
+    lister l;
 
-static void
-list1node(FILE *fp, node *n)
-{
     if (n == 0)
         return;
-    if (ISNONTERMINAL(TYPE(n))) {
-        int i;
-        for (i = 0; i < NCH(n); i++)
-            list1node(fp, CHILD(n, i));
-    }
-    else if (ISTERMINAL(TYPE(n))) {
-        switch (TYPE(n)) {
-        case INDENT:
-            ++level;
-            break;
-        case DEDENT:
-            --level;
-            break;
-        default:
-            if (atbol) {
-                int i;
-                for (i = 0; i < level; ++i)
-                    fprintf(fp, "\t");
-                atbol = 0;
-            }
-            if (TYPE(n) == NEWLINE) {
-                if (STR(n) != NULL)
-                    fprintf(fp, "%.*s", STRL(n), STR(n));
-                fprintf(fp, "\n");
-                atbol = 1;
-            }
-            else
-                fprintf(fp, "%.*s ", STRL(n), STR(n));
-            break;
+    l.fp = fp;
+    l.level = 0;
+    l.atbol = 1;
+    (void) PyNode_Visit(n, &v, &l);
+}
+
+/* Only the tokens are listed; the nonterminals are just walked through */
+static int
+list1token(void *arg, node *n)
+{
+    lister *l = (lister *)arg;
+    FILE *fp = l->fp;
+
+    switch (TYPE(n)) {
+    case INDENT:
+        ++l->level;
+        break;
+    case DEDENT:
+        --l->level;
+        break;
+    default:
+        if (l->atbol) {
+            int i;
+            for (i = 0; i < l->level; ++i)
+                fprintf(fp, "\t");
+            l->atbol = 0;
+        }
+        if (TYPE(n) == NEWLINE) {
+            if (STR(n) != NULL)
+                fprintf(fp, "%.*s", STRL(n), STR(n));
+            fprintf(fp, "\n");
+            l->atbol = 1;
         }
+        else
+            fprintf(fp, "%.*s ", STRL(n), STR(n));
+        break;
     }
-    else
-        fprintf(fp, "? ");
+    return 0;
 }
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""Generate Parser/chartype.c, the tokenizer's character class tables.
+
+Usage: makechartype.py [output]
+
+Identifier classes follow PEP 3131 (XID_Start and XID_Continue, plus '_'),
+taken from the Unicode database of the Python running this script.  The
+digit, hex-digit and blank classes are ASCII-only, as in the tokenizer.
+The flag values and CT_SHIFT must match Parser/chartype.h.
+"""
+
+import sys
+import unicodedata
+
+CT_ID_START = 0x01
+CT_ID_CONTINUE = 0x02
+CT_DIGIT = 0x04
+CT_XDIGIT = 0x08
+CT_SPACE = 0x10
+
+CT_SHIFT = 4
+BMP = 0x10000
+MAXUNICODE = 0x110000
+
+
+def chartype(c):
+    flags = 0
+    if 0xd800 <= c < 0xe000:
+        return flags            # Surrogates never survive UTF-8 validation
+    ch = chr(c)
+    if ch.isidentifier():
+        flags |= CT_ID_START
+    if ('a' + ch).isidentifier():
+        flags |= CT_ID_CONTINUE
+    if '0' <= ch <= '9':
+        flags |= CT_DIGIT
+    if ch in '0123456789abcdefABCDEF':
+        flags |= CT_XDIGIT
+    if ch in ' \t\014':
+        flags |= CT_SPACE
+    return flags
+
+
+def splitbins(types, shift):
+    """Split `types` into blocks of 1 << shift entries, sharing duplicates."""
+    size = 1 << shift
+    blocks = {}
+    index1 = []
+    index2 = []
+    for i in range(0, len(types), size):
+        block = tuple(types[i:i + size])
+        if block not in blocks:
+            blocks[block] = len(blocks)
+            index2.extend(block)
+        index1.append(blocks[block])
+    assert max(index1) < 256, "too many blocks for an unsigned char index"
+    return index1, index2
+
+
+def ranges(lo, hi):
+    """Run-length encode the types of [lo, hi) as (first, type) pairs."""
+    result = []
+    prev = None
+    for c in range(lo, hi):
+        t = chartype(c)
+        if t != prev:
+            result.append((c, t))
+            prev = t
+    return result
+
+
+def printarray(fp, decl, values, width=16):
+    fp.write("%s[%d] = {\n" % (decl, len(values)))
+    for i in range(0, len(values), width):
+        fp.write("    " + ", ".join(str(v) for v in values[i:i + width]))
+        fp.write(",\n")
+    fp.write("};\n\n")
+
+
+def main(argv):
+    output = argv[1] if len(argv) > 1 else "Parser/chartype.c"
+    bmp = [chartype(c) for c in range(BMP)]
+    index1, index2 = splitbins(bmp, CT_SHIFT)
+    astral = ranges(BMP, MAXUNICODE)
+
+    with open(output, "w") as fp:
+        fp.write("/* Generated by Parser/makechartype.py from the Unicode %s "
+                 "database */\n\n" % unicodedata.unidata_version)
+        fp.write('#include "chartype.h"\n\n')
+        printarray(fp, "const unsigned char _PyChar_ASCII", bmp[:128])
+        printarray(fp, "const unsigned char _PyChar_Index1", index1)
+        printarray(fp, "const unsigned char _PyChar_Index2", index2)
+        printarray(fp, "static const unsigned int astral_first",
+                   [first for first, _ in astral], 8)
+        printarray(fp, "static const unsigned char astral_type",
+                   [t for _, t in astral])
+        fp.write("""\
+/* Binary search for the run containing `c`, which is beyond the BMP */
+unsigned int
+_PyChar_AstralType(unsigned int c)
+{
+    int lo = 0;
+    int hi = %d;
+
+    if (c >= 0x%x)
+        return 0;
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (astral_first[mid] <= c)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return astral_type[lo];
+}
+""" % (len(astral), MAXUNICODE))
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+"""Generate Parser/scanner.h and Parser/scanner.c, the tokenizer's DFA.
+
+Usage: makescanner.py [Tokens [scanner.h [scanner.c]]]
+
+The DFA recognizes, from the first byte of a token, names, numbers, the
+prefix and opening quote of a string, and the operators of Grammar/Tokens
+that begin with an ASCII byte.  It runs over bytes: every byte from 0x80
+up falls into the single class SCAN_HIGH, which only names continue
+through, and the tokenizer checks those code points against the chartype
+tables as it takes the transition.  Each state's accept code says what
+the longest match so far is; SCAN_ERROR and SCAN_NUMBER1 reproduce the
+tokenizer's handling of malformed numbers.
+"""
+
+import re
+import sys
+
+HIGH = 128                      # The symbol standing for bytes 0x80-0xff
+NSYMBOLS = 129
+
+# Accept codes beyond the token types
+SCAN_NONE = 255                 # Not an accepting state
+SCAN_STRING = 254               # A string prefix and its opening quote
+SCAN_ERROR = 253                # A malformed number
+SCAN_NUMBER1 = 252              # A number, less its last byte
+
+
+class NFA:
+    """Thompson construction: fragments are (start, end) state pairs."""
+
+    def __init__(self):
+        self.arcs = []          # state -> {symbol: set of states}
+        self.eps = []           # state -> set of states
+        self.accept = {}        # state -> (priority, code)
+
+    def state(self):
+        self.arcs.append({})
+        self.eps.append(set())
+        return len(self.arcs) - 1
+
+    def chars(self, symbols):
+        s, e = self.state(), self.state()
+        for sym in symbols:
+            self.arcs[s].setdefault(sym, set()).add(e)
+        return s, e
+
+    def lit(self, text):
+        return self.seq(*[self.chars([ord(ch)]) for ch in text])
+
+    def seq(self, *frags):
+        for (s1, e1), (s2, e2) in zip(frags, frags[1:]):
+            self.eps[e1].add(s2)
+        return frags[0][0], frags[-1][1]
+
+    def alt(self, *frags):
+        s, e = self.state(), self.state()
+        for fs, fe in frags:
+            self.eps[s].add(fs)
+            self.eps[fe].add(e)
+        return s, e
+
+    def star(self, frag):
+        s, e = self.plus(frag)
+        self.eps[s].add(e)
+        return s, e
+
+    def plus(self, frag):
+        s, e = self.state(), self.state()
+        self.eps[s].add(frag[0])
+        self.eps[frag[1]] |= {frag[0], e}
+        return s, e
+
+    def opt(self, frag):
+        s, e = self.alt(frag)
+        self.eps[s].add(e)
+        return s, e
+
+    def rule(self, start, frag, priority, code):
+        self.eps[start].add(frag[0])
+        self.accept[frag[1]] = (priority, code)
+
+
+def charset(spec):
+    """Symbols of a character-class body like 'a-zA-Z_'."""
+    symbols = set()
+    for lo, hi in re.findall(r"(.)(?:-(.))?", spec):
+        symbols.update(range(ord(lo), ord(hi or lo) + 1))
+    return symbols
+
+
+def readoperators(path):
+    ops = []
+    with open(path, encoding="utf-8") as fp:
+        number = 0
+        for line in fp:
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            for op in re.findall(r"'([^']+)'", line):
+                if ord(op[0]) < 0x80:
+                    ops.append((op, number))
+            number += 1
+    return ops
+
+
+def rules(nfa, start, operators, NAME, NUMBER):
+    c = lambda spec: nfa.chars(charset(spec))
+    D = lambda: c("0-9")
+
+    def number(frag):
+        nfa.rule(start, frag, 1, NUMBER)
+
+    def error(frag):
+        nfa.rule(start, frag, 1, SCAN_ERROR)
+
+    def exponent():
+        return nfa.seq(c("eE"), nfa.opt(c("+-")), nfa.plus(D()))
+
+    def j():
+        return nfa.opt(c("jJ"))
+
+    # Names, and the string prefixes that look like them
+    name = nfa.seq(c("a-zA-Z_"),
+                   nfa.star(nfa.alt(c("a-zA-Z0-9_"), nfa.chars([HIGH]))))
+    nfa.rule(start, name, 2, NAME)
+    for prefix in ("", "b", "br", "r", "u", "ur"):
+        frag = nfa.seq(*[c(ch + ch.upper()) for ch in prefix],
+                       c("'\"")) if prefix else c("'\"")
+        nfa.rule(start, frag, 0, SCAN_STRING)
+
+    # Integers: decimal, hex, octal (old and new style) and binary
+    number(nfa.seq(c("1-9"), nfa.star(D()), nfa.opt(c("lL"))))
+    number(nfa.seq(nfa.lit("0"), nfa.star(c("0-7")), nfa.opt(c("lL"))))
+    for marker, digits in (("xX", "0-9a-fA-F"), ("oO", "0-7"), ("bB", "01")):
+        number(nfa.seq(nfa.lit("0"), c(marker), nfa.plus(c(digits)),
+                       nfa.opt(c("lL"))))
+        error(nfa.seq(nfa.lit("0"), c(marker)))
+
+    # Floats and imaginaries
+    number(nfa.seq(nfa.plus(D()), nfa.lit("."), nfa.star(D()),
+                   nfa.opt(exponent()), j()))
+    number(nfa.seq(nfa.lit("."), nfa.plus(D()), nfa.opt(exponent()), j()))
+    number(nfa.seq(nfa.plus(D()), exponent(), j()))
+    number(nfa.seq(nfa.plus(D()), c("jJ")))
+
+    # An exponent sign with no digits after it is an error
+    error(nfa.seq(nfa.plus(D()), nfa.opt(nfa.seq(nfa.lit("."), nfa.star(D()))),
+                  c("eE"), c("+-")))
+    error(nfa.seq(nfa.lit("."), nfa.plus(D()), c("eE"), c("+-")))
+
+    # An old-style octal with 8 or 9 in it is an error, unless it turns
+    # out to be a float; "09e" with no exponent digits is the number "09".
+    error(nfa.seq(nfa.lit("0"), nfa.star(c("0-7")), c("89"), nfa.star(D())))
+    nfa.rule(start, nfa.seq(nfa.lit("0"), nfa.star(c("0-7")), c("89"),
+                            nfa.star(D()), c("eE")), 1, SCAN_NUMBER1)
+
+    for op, number_ in operators:
+        nfa.rule(start, nfa.lit(op), 1, number_)
+
+
+def closure(nfa, states):
+    stack = list(states)
+    result = set(states)
+    while stack:
+        q = stack.pop()
+        for r in nfa.eps[q]:
+            if r not in result:
+                result.add(r)
+                stack.append(r)
+    return frozenset(result)
+
+
+def subset(nfa, start):
+    """Return (transitions, accepts) of the DFA, state 0 dead, 1 start."""
+    dead = frozenset()
+    ids = {dead: 0}
+    order = [dead]
+    first = closure(nfa, [start])
+    ids[first] = 1
+    order.append(first)
+    trans = []
+    i = 0
+    while i < len(order):
+        S = order[i]
+        row = []
+        for sym in range(NSYMBOLS):
+            T = set()
+            for q in S:
+                T |= nfa.arcs[q].get(sym, set())
+            T = closure(nfa, T) if T else dead
+            if T not in ids:
+                ids[T] = len(order)
+                order.append(T)
+            row.append(ids[T])
+        trans.append(row)
+        i += 1
+    accepts = []
+    for S in order:
+        best = None
+        for q in S:
+            if q in nfa.accept and (best is None or nfa.accept[q] < best):
+                best = nfa.accept[q]
+        accepts.append(SCAN_NONE if best is None else best[1])
+    return trans, accepts
+
+
+def minimize(trans, accepts):
+    """Moore's partition refinement, keeping dead as 0 and start as 1."""
+    n = len(trans)
+    block = [0 if i == 0 else 1 + accepts[i] for i in range(n)]
+    while True:
+        sig = {}
+        newblock = []
+        for i in range(n):
+            key = (block[i], tuple(block[t] for t in trans[i]))
+            newblock.append(sig.setdefault(key, len(sig)))
+        if len(sig) == len(set(block)):
+            break
+        block = newblock
+    # Renumber: dead 0, start 1, the rest in order of first appearance
+    number = {block[0]: 0, block[1]: 1}
+    for i in range(n):
+        number.setdefault(block[i], len(number))
+    m = len(number)
+    newtrans = [None] * m
+    newaccepts = [None] * m
+    for i in range(n):
+        b = number[block[i]]
+        newtrans[b] = [number[block[t]] for t in trans[i]]
+        newaccepts[b] = accepts[i]
+    return newtrans, newaccepts
+
+
+def printarray(fp, decl, values, perline=16):
+    fp.write("%s[%d] = {\n" % (decl, len(values)))
+    for i in range(0, len(values), perline):
+        fp.write("    " + ", ".join(str(v) for v in values[i:i + perline]) +
+                 ",\n")
+    fp.write("};\n\n")
+
+
+def main(argv):
+    tokenspath = argv[1] if len(argv) > 1 else "Grammar/Tokens"
+    headerpath = argv[2] if len(argv) > 2 else "Parser/scanner.h"
+    sourcepath = argv[3] if len(argv) > 3 else "Parser/scanner.c"
+
+    NAME, NUMBER = 1, 2
+    nfa = NFA()
+    start = nfa.state()
+    rules(nfa, start, readoperators(tokenspath), NAME, NUMBER)
+    trans, accepts = minimize(*subset(nfa, start))
+    assert len(trans) < 256, "too many states for unsigned char"
+
+    # Bytes with identical columns share a class; dead bytes are class 0
+    columns = {}
+    symclass = []
+    deadcol = tuple([0] * len(trans))
+    columns[deadcol] = 0
+    for sym in range(NSYMBOLS):
+        col = tuple(row[sym] for row in trans)
+        symclass.append(columns.setdefault(col, len(columns)))
+    nclasses = len(columns)
+    table = [0] * (len(trans) * nclasses)
+    for sym in range(NSYMBOLS):
+        for state, row in enumerate(trans):
+            table[state * nclasses + symclass[sym]] = row[sym]
+    byteclass = [symclass[b] if b < 0x80 else symclass[HIGH]
+                 for b in range(256)]
+    namestate = trans[1][ord("a")]
+
+    with open(headerpath, "w") as fp:
+        fp.write("""\
+/* Generated by Parser/makescanner.py from Grammar/Tokens */
+
+#ifndef Py_SCANNER_H
+#define Py_SCANNER_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A DFA over the bytes of a token.  State 0 is dead.  From state s, byte b
+   leads to _PyScan_Next[s * SCAN_NCLASSES + _PyScan_Class[b]]; the bytes of
+   class SCAN_HIGH continue a name only if they encode an identifier
+   character.  _PyScan_Accept[s] is the token type of the longest match
+   ending in s, or one of the codes below. */
+
+#define SCAN_NSTATES    %d
+#define SCAN_NCLASSES   %d
+#define SCAN_START      1       /* At the first byte of a token */
+#define SCAN_NAME       %-8d/* Inside a name */
+#define SCAN_HIGH       %-8d/* The class of bytes 0x80-0xff */
+
+#define SCAN_NONE       %d     /* Not an accepting state */
+#define SCAN_STRING     %d     /* A string's prefix and opening quote */
+#define SCAN_ERROR      %d     /* A malformed number */
+#define SCAN_NUMBER1    %d     /* A number, less its last byte */
+
+extern const unsigned char _PyScan_Class[256];
+extern const unsigned char _PyScan_Accept[SCAN_NSTATES];
+extern const unsigned char _PyScan_Next[SCAN_NSTATES * SCAN_NCLASSES];
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !Py_SCANNER_H */
+""" % (len(trans), nclasses, namestate, symclass[HIGH],
+       SCAN_NONE, SCAN_STRING, SCAN_ERROR, SCAN_NUMBER1))
+
+    with open(sourcepath, "w") as fp:
+        fp.write("/* Generated by Parser/makescanner.py from Grammar/Tokens "
+                 "*/\n\n")
+        fp.write('#include "scanner.h"\n\n')
+        printarray(fp, "const unsigned char _PyScan_Class", byteclass)
+        printarray(fp, "const unsigned char _PyScan_Accept", accepts)
+        fp.write("const unsigned char _PyScan_Next[%d] = {\n" % len(table))
+        for state in range(len(trans)):
+            row = table[state * nclasses:(state + 1) * nclasses]
+            fp.write("    /* %d */\n" % state)
+            for i in range(0, len(row), 16):
+                fp.write("    " + ", ".join(str(v) for v in row[i:i + 16]) +
+                         ",\n")
+        fp.write("};\n")
+
+
+if __name__ == "__main__":
+    main(sys.argv)
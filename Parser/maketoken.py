@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""Generate Include/token.h and Parser/token.c from Grammar/Tokens.
+
+Usage: maketoken.py [Tokens [token.h [token.c]]]
+
+Each line of Grammar/Tokens names a token type, numbered in order.  An
+operator's name is followed by its quoted spellings.  The operators become
+a trie over their UTF-8 bytes, which PyToken_Match walks to find the
+longest operator at a point in the source, whether the tokenizer is
+scanning or pgen is translating the grammar's string labels.
+"""
+
+import re
+import sys
+
+HEADER = """\
+/* Token types */
+/* Generated by Parser/maketoken.py from Grammar/Tokens */
+
+#ifndef Py_TOKEN_H
+#define Py_TOKEN_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#undef TILDE   /* Prevent clash of our definition with system macro. Ex AIX, ioctl.h */
+
+%(defines)s
+#define N_TOKENS          %(ntokens)d
+
+/* Special definitions for cooperation with parser */
+
+#define NT_OFFSET         256
+#define EXTRA_OP_OFFSET   %(extra)d
+
+#define ISTERMINAL(x)     ((x) < NT_OFFSET)
+#define ISNONTERMINAL(x)  ((x) >= NT_OFFSET)
+#define ISEOF(x)          ((x) == ENDMARKER)
+#define ISEXTRAOP(x)      ((x) >= EXTRA_OP_OFFSET && (x) < EXTRA_OP_OFFSET + 4)
+
+PyAPI_DATA(const unsigned char *) _PyParser_TokenNames[]; /* Token names */
+
+/* Operator trie over UTF-8 bytes, in Parser/token.c.  _PyToken_OpStart maps
+   an operator's first byte to its state; state 0 is "no operator".  A
+   state's arcs run from _PyToken_OpArc[_PyToken_OpArcs[state]] up to a zero
+   byte. */
+PyAPI_DATA(const unsigned char) _PyToken_OpStart[256];
+PyAPI_DATA(const unsigned char) _PyToken_OpType[];
+PyAPI_DATA(const unsigned char) _PyToken_OpArcs[];
+PyAPI_DATA(const unsigned char) _PyToken_OpArc[][2];
+
+%(match)s
+#ifdef __cplusplus
+}
+#endif
+#endif /* !Py_TOKEN_H */
+"""
+
+MATCH = """\
+/* Find the longest operator starting at `p`, which is before `end`.  Return
+   its length in bytes and store its type in *type, or return 0 if there's
+   no operator at `p`. */
+static inline int
+PyToken_Match(const unsigned char *p, const unsigned char *end, int *type)
+{
+    int state = _PyToken_OpStart[*p];
+    int length = 0;
+    int i = 0;
+
+    while (state != 0) {
+        const unsigned char *arc;
+
+        i++;
+        if (_PyToken_OpType[state] != OP) {
+            length = i;
+            *type = _PyToken_OpType[state];
+        }
+        if (p + i == end)
+            break;
+        for (arc = _PyToken_OpArc[_PyToken_OpArcs[state]]; arc[0] != 0; arc += 2)
+            if (arc[0] == p[i])
+                break;
+        state = arc[1];
+    }
+    return length;
+}
+"""
+
+
+def readtokens(path):
+    tokens = []
+    with open(path, encoding="utf-8") as fp:
+        for line in fp:
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            name = line.split()[0]
+            ops = re.findall(r"'([^']+)'", line)
+            tokens.append((name, ops))
+    return tokens
+
+
+def maketrie(tokens, types):
+    """Return the states of a trie over the operators' UTF-8 bytes as a list
+    of [type, {byte: state}], where state 0 is the root."""
+    states = [[types["OP"], {}]]
+    for number, (name, ops) in enumerate(tokens):
+        for op in ops:
+            state = 0
+            for byte in op.encode("utf-8"):
+                assert byte != 0
+                if byte not in states[state][1]:
+                    states[state][1][byte] = len(states)
+                    states.append([types["OP"], {}])
+                state = states[state][1][byte]
+            assert states[state][0] == types["OP"], "duplicate operator " + op
+            states[state][0] = number
+    assert len(states) < 256, "too many operator states for unsigned char"
+    return states
+
+
+def printarray(fp, decl, values, perline=16):
+    fp.write("%s[%d] = {\n" % (decl, len(values)))
+    for i in range(0, len(values), perline):
+        fp.write("    " + ", ".join(str(v) for v in values[i:i + perline]) +
+                 ",\n")
+    fp.write("};\n\n")
+
+
+def writeheader(path, tokens, types):
+    defines = []
+    for number, (name, ops) in enumerate(tokens):
+        defines.append("#define %-18s%2d" % (name, number))
+    with open(path, "w") as fp:
+        fp.write(HEADER % dict(defines="\n".join(defines),
+                               ntokens=len(tokens),
+                               extra=types["CIRCLEDPLUS"],
+                               match=MATCH))
+
+
+def writesource(path, tokens, types):
+    states = maketrie(tokens, types)
+
+    # The root's arcs become a direct table; the other states' arcs are
+    # zero-terminated runs of (byte, state) pairs.
+    start = [0] * 256
+    for byte, state in states[0][1].items():
+        start[byte] = state
+    arcs = [[0, 0]]
+    first = [0]
+    for optype, children in states[1:]:
+        if not children:
+            first.append(0)
+            continue
+        first.append(len(arcs))
+        for byte in sorted(children):
+            arcs.append([byte, children[byte]])
+        arcs.append([0, 0])
+    assert len(arcs) < 256, "too many operator arcs for unsigned char"
+
+    with open(path, "w") as fp:
+        fp.write("/* Generated by Parser/maketoken.py from Grammar/Tokens */"
+                 "\n\n")
+        fp.write('#include "Python.h"\n#include "token.h"\n\n')
+        fp.write("/* Token names */\n")
+        fp.write("const unsigned char *_PyParser_TokenNames[] = {\n")
+        for name, ops in tokens:
+            if types[name] > types["OP"]:
+                name = "<%s>" % name
+            fp.write('    CUC("%s"),\n' % name)
+        fp.write('    CUC("<N_TOKENS>")\n};\n\n')
+
+        fp.write("/* Operator trie; see PyToken_Match in token.h */\n\n")
+        printarray(fp, "const unsigned char _PyToken_OpStart", start)
+        printarray(fp, "const unsigned char _PyToken_OpType",
+                   [optype for optype, children in states])
+        printarray(fp, "const unsigned char _PyToken_OpArcs", first)
+        fp.write("const unsigned char _PyToken_OpArc[%d][2] = {\n"
+                 % len(arcs))
+        for byte, state in arcs:
+            fp.write("    {0x%02x, %d},\n" % (byte, state))
+        fp.write("};\n")
+
+
+def main(argv):
+    tokenspath = argv[1] if len(argv) > 1 else "Grammar/Tokens"
+    headerpath = argv[2] if len(argv) > 2 else "Include/token.h"
+    sourcepath = argv[3] if len(argv) > 3 else "Parser/token.c"
+    tokens = readtokens(tokenspath)
+    types = {name: number for number, (name, ops) in enumerate(tokens)}
+    writeheader(headerpath, tokens, types)
+    writesource(sourcepath, tokens, types)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -4,163 +4,330 @@
 #include "node.h"
 #include "pymem.h"
 #include "errcode.h"
+#include "linetable.h"
+
+/* A tree's nodes come from an arena that belongs to its root.  PyNode_New
+   makes the root at the head of the arena, PyNode_AddChild carves child
+   arrays out of the arena's chunks, and PyNode_Free releases the chunks all
+   at once, however many nodes they hold.
+
+   A child array holds a power of two of nodes, so a node's capacity
+   follows from its number of children.  One-child nodes are by far the
+   most common, and they take just the one.  When an array fills, the
+   children move to one twice the size, and the old array goes on the
+   arena's free list for its size, for the next node that needs one.  Since
+   only the node being parsed gets children, arrays seldom wait there long.
+
+   An array that's a good part of a chunk gets a chunk of its own. */
+
+#define CHUNK_NODES     2048    /* Nodes in an ordinary chunk */
+#define NCLASSES        32      /* Sizes of child array, 1 << 0 to 1 << 31 */
+
+typedef struct _chunk {
+    struct _chunk       *c_next;
+    size_t              c_size;         /* In bytes, header and all */
+} chunk;
+
+#define CHUNK_NODE(c)   ((node *)((c) + 1))
+
+typedef struct {
+    node                a_root;         /* Must be first */
+    chunk               *a_chunks;
+    node                *a_next;        /* Free space in the newest chunk */
+    node                *a_end;
+    node                *a_free[NCLASSES];/* Free arrays of 1 << i nodes,
+                                           linked through their first */
+    const unsigned char *a_source;      /* What the tokens' text is in */
+    linetable           *a_lines;       /* Its lines, once needed */
+} nodearena;
+
+#define ARENA(root)     ((nodearena *)(root))
+#define NEXTFREE(n)     (*(node **)(n))
 
 node *
 PyNode_New(int type)
 {
-    node *n = PyMem_MALLOC(1 * sizeof(node));
-    if (n == NULL)
+    nodearena *arena = PyMem_MALLOC(sizeof(nodearena));
+    node *n;
+
+    if (arena == NULL)
         return NULL;
+    arena->a_chunks = NULL;
+    arena->a_next = arena->a_end = NULL;
+    memset(arena->a_free, 0, sizeof(arena->a_free));
+    arena->a_source = NULL;
+    arena->a_lines = NULL;
+
+    n = &arena->a_root;
     n->n_type = type;
-    n->n_str = NULL;
-    n->n_str_length = 0;
-    n->n_lineno = 0;
     n->n_nchildren = 0;
     n->n_child = NULL;
     return n;
 }
 
-/* See comments at XXXROUNDUP below.  Returns -1 on overflow. */
-static int
-fancy_roundup(int n)
+static node *
+newchunk(nodearena *arena, size_t nodes)
 {
-    /* Round up to the closest power of 2 >= n. */
-    int result = 256;
-    assert(n > 128);
-    while (result < n) {
-        result <<= 1;
-        if (result <= 0)
-            return -1;
-    }
-    return result;
+    size_t size = sizeof(chunk) + nodes * sizeof(node);
+    chunk *c = (chunk *)PyMem_MALLOC(size);
+
+    if (c == NULL)
+        return NULL;
+    c->c_next = arena->a_chunks;
+    c->c_size = size;
+    arena->a_chunks = c;
+    return CHUNK_NODE(c);
 }
 
-/* A gimmick to make massive numbers of reallocs quicker.  The result is
- * a number >= the input.  In PyNode_AddChild, it's used like so, when
- * we're about to add child number current_size + 1:
- *
- *     if XXXROUNDUP(current_size) < XXXROUNDUP(current_size + 1):
- *         allocate space for XXXROUNDUP(current_size + 1) total children
- *     else:
- *         we already have enough space
- *
- * Since a node starts out empty, we must have
- *
- *     XXXROUNDUP(0) < XXXROUNDUP(1)
- *
- * so that we allocate space for the first child.  One-child nodes are very
- * common (presumably that would change if we used a more abstract form
- * of syntax tree), so to avoid wasting memory it's desirable that
- * XXXROUNDUP(1) == 1.  That in turn forces XXXROUNDUP(0) == 0.
- *
- * Else for 2 <= n <= 128, we round up to the closest multiple of 4.  Why 4?
- * Rounding up to a multiple of an exact power of 2 is very efficient, and
- * most nodes with more than one child have <= 4 kids.
- *
- * Else we call fancy_roundup() to grow proportionately to n.  We've got an
- * extreme case then (like test_longexp.py), and on many platforms doing
- * anything less than proportional growth leads to exorbitant runtime
- * (e.g., MacPython), or extreme fragmentation of user address space (e.g.,
- * Win98).
- *
- * In a run of compileall across the 2.3a0 Lib directory, Andrew MacIntyre
- * reported that, with this scheme, 89% of PyObject_REALLOC calls in
- * PyNode_AddChild passed 1 for the size, and 9% passed 4.  So this usually
- * wastes very little memory, but is very effective at sidestepping
- * platform-realloc disasters on vulnerable platforms.
- *
- * Note that this would be straightforward if a node stored its current
- * capacity.  The code is tricky to avoid that.
- */
-#define XXXROUNDUP(n) ((n) <= 1 ? (n) :                 \
-               (n) <= 128 ? (((n) + 3) & ~3) :          \
-               fancy_roundup(n))
+/* An array of 1 << k nodes from the arena, or NULL for no memory */
+static node *
+allocarray(nodearena *arena, int k)
+{
+    size_t nodes = (size_t)1 << k;
+    node *n;
 
+    if (arena->a_free[k] != NULL) {
+        n = arena->a_free[k];
+        arena->a_free[k] = NEXTFREE(n);
+        return n;
+    }
+    if (nodes > CHUNK_NODES / 4) {
+        if (nodes > PY_SIZE_MAX / sizeof(node) - 1)
+            return NULL;
+        return newchunk(arena, nodes);
+    }
+    if ((size_t)(arena->a_end - arena->a_next) < nodes) {
+        n = newchunk(arena, CHUNK_NODES);
+        if (n == NULL)
+            return NULL;
+        arena->a_next = n;
+        arena->a_end = n + CHUNK_NODES;
+    }
+    n = arena->a_next;
+    arena->a_next += nodes;
+    return n;
+}
 
 int
-PyNode_AddChild(register node *n1, int type,
-                const unsigned char *str, size_t str_length,
-                int lineno, int col_offset)
+PyNode_AddChild(node *tree, register node *n1, int type,
+                const unsigned char *str, size_t str_length)
 {
     const int nch = n1->n_nchildren;
-    int current_capacity;
-    int required_capacity;
     node *n;
 
     if (nch == INT_MAX || nch < 0)
         return E_OVERFLOW;
 
-    current_capacity = XXXROUNDUP(nch);
-    required_capacity = XXXROUNDUP(nch + 1);
-    if (current_capacity < 0 || required_capacity < 0)
-        return E_OVERFLOW;
-    if (current_capacity < required_capacity) {
-        if (required_capacity > PY_SIZE_MAX / sizeof(node)) {
-            return E_NOMEM;
-        }
-        n = n1->n_child;
-        n = (node *) PyMem_REALLOC(n, required_capacity * sizeof(node));
+    if ((nch & (nch - 1)) == 0) {
+        /* No children, or a full array of 1 << k: move to 1 << (k + 1) */
+        nodearena *arena = ARENA(tree);
+        int k = nch == 0 ? 0 : 32 - __builtin_clz((unsigned int)nch);
+
+        if (k >= NCLASSES)
+            return E_OVERFLOW;
+        n = allocarray(arena, k);
         if (n == NULL)
             return E_NOMEM;
+        if (nch > 0) {
+            memcpy(n, n1->n_child, nch * sizeof(node));
+            NEXTFREE(n1->n_child) = arena->a_free[k - 1];
+            arena->a_free[k - 1] = n1->n_child;
+        }
         n1->n_child = n;
     }
 
     n = &n1->n_child[n1->n_nchildren++];
     n->n_type = type;
-    n->n_str = str;
-    n->n_str_length = str_length;
-    n->n_lineno = lineno;
-    n->n_col_offset = col_offset;
-    n->n_nchildren = 0;
-    n->n_child = NULL;
+    if (ISTERMINAL(type)) {
+        n->n_str_length = str_length;
+        n->n_str = str;
+    }
+    else {
+        n->n_nchildren = 0;
+        n->n_child = NULL;
+    }
     return 0;
 }
 
-/* Forward */
-static void freechildren(node *);
-static Py_ssize_t sizeofchildren(node *n);
+void
+PyNode_Free(node *n)
+{
+    nodearena *arena;
+    chunk *c, *next;
 
+    if (n == NULL)
+        return;
+    arena = ARENA(n);
+    for (c = arena->a_chunks; c != NULL; c = next) {
+        next = c->c_next;
+        PyMem_FREE(c);
+    }
+    PyLineTable_Free(arena->a_lines);
+    PyMem_FREE(arena);
+}
 
 void
-PyNode_Free(node *n)
+_PyNode_SetSource(node *tree, const unsigned char *source, linetable *lines)
 {
-    if (n != NULL) {
-        freechildren(n);
-        PyMem_FREE(n);
+    nodearena *arena = ARENA(tree);
+
+    PyLineTable_Free(arena->a_lines);
+    arena->a_source = source;
+    arena->a_lines = lines;
+}
+
+/* The offset of the node's first token in the source, or -1 if the tree
+   doesn't know its source.  Makes the line table if need be. */
+static Py_ssize_t
+startof(node *tree, node *n)
+{
+    nodearena *arena = ARENA(tree);
+
+    while (NCH(n) > 0)
+        n = CHILD(n, 0);
+    if (STR(n) == NULL || arena->a_source == NULL)
+        return -1;
+    if (arena->a_lines == NULL) {
+        const char *s = (const char *)arena->a_source;
+        arena->a_lines = PyLineTable_New(arena->a_source, strlen(s));
+        if (arena->a_lines == NULL)
+            return -1;
     }
+    return STR(n) - arena->a_source;
+}
+
+int
+PyNode_LineNo(node *tree, node *n)
+{
+    Py_ssize_t offset = startof(tree, n);
+
+    if (offset < 0)
+        return 0;
+    return PyLineTable_Line(ARENA(tree)->a_lines, offset);
+}
+
+int
+PyNode_ColOffset(node *tree, node *n)
+{
+    Py_ssize_t offset = startof(tree, n);
+
+    if (offset < 0)
+        return -1;
+    return PyLineTable_Column(ARENA(tree)->a_lines, offset, LT_BYTES);
 }
 
 Py_ssize_t
 _PyNode_SizeOf(node *n)
 {
     Py_ssize_t res = 0;
+    chunk *c;
 
-    if (n != NULL)
-        res = sizeof(node) + sizeofchildren(n);
+    if (n != NULL) {
+        res = sizeof(nodearena);
+        for (c = ARENA(n)->a_chunks; c != NULL; c = c->c_next)
+            res += c->c_size;
+    }
     return res;
 }
 
-static void
-freechildren(node *n)
+/* Where a walk is in one of the nonterminals it's inside: the next of the
+   node's children to visit */
+typedef struct {
+    node        *w_node;
+    node        *w_next;
+} walkentry;
+
+#define INITWALK        64      /* Walk entries on the C stack */
+
+/* Double the walk stack at *base, which starts as `init`; returns 0, or
+   E_NOMEM */
+static int
+growwalk(walkentry **base, walkentry *init, int *size)
+{
+    size_t n = (size_t)*size * 2;
+    walkentry *w;
+
+    if (n > INT_MAX || n > PY_SSIZE_T_MAX / sizeof(walkentry))
+        return E_NOMEM;
+    if (*base == init) {
+        w = (walkentry *)PyMem_MALLOC(n * sizeof(walkentry));
+        if (w != NULL)
+            memcpy(w, init, *size * sizeof(walkentry));
+    }
+    else
+        w = (walkentry *)PyMem_REALLOC(*base, n * sizeof(walkentry));
+    if (w == NULL)
+        return E_NOMEM;
+    *base = w;
+    *size = (int)n;
+    return 0;
+}
+
+static inline int
+enter(const nodevisitor *v, void *arg, node *n)
 {
-    int i;
-    for (i = NCH(n); --i >= 0; )
-        freechildren(CHILD(n, i));
-    if (n->n_child != NULL)
-        PyMem_FREE(n->n_child);
+    int i = TYPE(n) - NT_OFFSET;
+
+    if (i < 0)
+        return v->v_token != NULL ? v->v_token(arg, n) : 0;
+    if (i < v->v_ntypes && v->v_enter != NULL && v->v_enter[i] != NULL)
+        return v->v_enter[i](arg, n);
+    return 0;
 }
 
-static Py_ssize_t
-sizeofchildren(node *n)
+static inline int
+leave(const nodevisitor *v, void *arg, node *n)
 {
-    Py_ssize_t res = 0;
-    int i;
-    for (i = NCH(n); --i >= 0; )
-        res += sizeofchildren(CHILD(n, i));
-    if (n->n_child != NULL)
-        /* allocated size of n->n_child array */
-        res += XXXROUNDUP(NCH(n)) * sizeof(node);
-    if (STR(n) != NULL)
-        res += strlen((const char *)STR(n)) + 1;
-    return res;
+    int i = TYPE(n) - NT_OFFSET;
+
+    if (i >= 0 && i < v->v_ntypes && v->v_leave != NULL &&
+        v->v_leave[i] != NULL)
+        return v->v_leave[i](arg, n);
+    return 0;
+}
+
+int
+PyNode_Visit(node *n, const nodevisitor *v, void *arg)
+{
+    walkentry init[INITWALK];
+    walkentry *base = init;
+    int size = INITWALK;
+    int depth = 0;
+    int err;
+
+    for (;;) {
+        err = enter(v, arg, n);
+        if (err > 0)
+            break;
+        if (err == 0 && NCH(n) > 0) {
+            /* Down to the first child */
+            if (depth == size && (err = growwalk(&base, init, &size)) != 0)
+                break;
+            base[depth].w_node = n;
+            base[depth].w_next = CHILD(n, 1);
+            depth++;
+            n = CHILD(n, 0);
+            continue;
+        }
+        if ((err = leave(v, arg, n)) > 0)
+            break;
+
+        /* Up to the nearest node with children left, and on to the next */
+        while (depth > 0 &&
+               base[depth - 1].w_next == RCHILD(base[depth - 1].w_node, 0)) {
+            depth--;
+            if ((err = leave(v, arg, base[depth].w_node)) > 0)
+                goto done;
+        }
+        if (depth == 0) {
+            err = 0;
+            break;
+        }
+        n = base[depth - 1].w_next++;
+    }
+
+  done:
+    if (base != init)
+        PyMem_FREE(base);
+    return err;
 }
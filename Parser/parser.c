@@ -11,9 +11,14 @@
 #include "grammar.h"
 #include "node.h"
 #include "parser.h"
+#include "parsetok.h"
 #include "errcode.h"
 
 
+#ifdef PY_PARSER_DIRECT
+extern grammar _PyParser_Grammar;
+#endif
+
 #ifndef NDEBUG
 #define D(x) x
 #else
@@ -27,22 +32,53 @@ static void s_reset(stack *);
 static void
 s_reset(stack *s)
 {
-    s->s_top = &s->s_base[MAXSTACK];
+    s->s_base = s->s_init;
+    s->s_size = INITSTACK;
+    s->s_top = &s->s_base[s->s_size];
 }
 
-#define s_empty(s) ((s)->s_top == &(s)->s_base[MAXSTACK])
+static void
+s_free(stack *s)
+{
+    if (s->s_base != s->s_init)
+        PyMem_FREE(s->s_base);
+}
+
+/* Double the stack.  It grows down, so the entries move to the top half
+   of the new array. */
+static int
+s_grow(stack *s)
+{
+    stackentry *base;
+    size_t size;
+
+    if (s->s_size > INT_MAX / 2 ||
+        (size_t)s->s_size > (size_t)-1 / 2 / sizeof(stackentry))
+        return E_NOMEM;
+    size = 2 * s->s_size * sizeof(stackentry);
+    base = (stackentry *)PyMem_MALLOC(size);
+    if (base == NULL)
+        return E_NOMEM;
+    memcpy(base + s->s_size, s->s_base, s->s_size * sizeof(stackentry));
+    s_free(s);
+    s->s_base = base;
+    s->s_top = base + s->s_size;
+    s->s_size *= 2;
+    return 0;
+}
 
 static int
 s_push(register stack *s, dfa *d, node *parent)
 {
     register stackentry *top;
-    if (s->s_top == s->s_base) {
-        fprintf(stderr, "s_push: parser stack overflow\n");
+    if (s->s_top == s->s_base && s_grow(s) != 0) {
+        fprintf(stderr, "s_push: no memory to grow parser stack\n");
         return E_NOMEM;
     }
     top = --s->s_top;
     top->s_dfa = d;
     top->s_parent = parent;
+    top->s_slot = -1;
     top->s_state = 0;
     return 0;
 }
@@ -66,13 +102,17 @@ s_pop(register stack *s)
 
 /* PARSER CREATION */
 
-parser_state *
-PyParser_New(grammar *g, int start)
+static parser_state *
+newparser(grammar *g, int start, int build)
 {
     parser_state *ps;
 
+    /* The grammar is shared and never written here: its accelerators come
+       from graminit.c, or from a call to PyGrammar_AddAccelerators before
+       any parsing starts. */
+    assert(g->g_accel);
     if (!g->g_accel)
-        PyGrammar_AddAccelerators(g);
+        return NULL;
     ps = (parser_state *)PyMem_MALLOC(sizeof(parser_state));
     if (ps == NULL)
         return NULL;
@@ -80,36 +120,152 @@ PyParser_New(grammar *g, int start)
 #ifdef PY_PARSER_REQUIRES_FUTURE_KEYWORD
     ps->p_flags = 0;
 #endif
-    ps->p_tree = PyNode_New(start);
-    if (ps->p_tree == NULL) {
-        PyMem_FREE(ps);
-        return NULL;
+    ps->p_tree = NULL;
+    ps->p_callbacks = NULL;
+    ps->p_arg = NULL;
+    ps->p_keep = NULL;
+    if (build) {
+        ps->p_tree = PyNode_New(start);
+        if (ps->p_tree == NULL) {
+            PyMem_FREE(ps);
+            return NULL;
+        }
     }
     s_reset(&ps->p_stack);
     (void) s_push(&ps->p_stack, PyGrammar_FindDFA(g, start), ps->p_tree);
     return ps;
 }
 
+parser_state *
+PyParser_New(grammar *g, int start)
+{
+    return newparser(g, start, 1);
+}
+
+/* A parser that only recognizes its input: it runs the same machine, but
+   makes no nodes, and its p_tree stays NULL.  Every stack entry's
+   s_parent is NULL too, which is how shift and push know. */
+parser_state *
+PyParser_NewRecognizer(grammar *g, int start)
+{
+    return newparser(g, start, 0);
+}
+
+/* A parser that leaves out the nodes of nonterminals with only one child,
+   putting the child in their place, except for the nonterminals listed in
+   `keep` (which ends with 0). */
+parser_state *
+PyParser_NewCollapsing(grammar *g, int start, const int *keep)
+{
+    parser_state *ps = newparser(g, start, 1);
+    size_t size = NBYTES(g->g_ndfas);
+
+    if (ps == NULL)
+        return NULL;
+    ps->p_keep = (bitset)PyMem_MALLOC(size);
+    if (ps->p_keep == NULL) {
+        PyParser_Delete(ps);
+        return NULL;
+    }
+    memset(ps->p_keep, 0, size);
+    for (; keep != NULL && *keep != 0; keep++)
+        addbit(ps->p_keep, *keep - NT_OFFSET);
+#ifdef PY_PARSER_REQUIRES_FUTURE_KEYWORD
+    {
+        /* future_hack reads the whole of an import_stmt's tree */
+        int i;
+        for (i = 0; i < g->g_ndfas; i++) {
+            const char *name = g->g_dfa[i].d_name;
+            if (strncmp(name, "import_", 7) == 0 ||
+                strcmp(name, "dotted_name") == 0)
+                addbit(ps->p_keep, i);
+        }
+    }
+#endif
+    return ps;
+}
+
+/* A parser that hands its nodes to `cb` as it makes them, and builds no
+   tree.  Returns NULL if there's no memory, or if pc_push fails for the
+   start symbol. */
+parser_state *
+PyParser_NewCallbacks(grammar *g, int start, const parser_callbacks *cb,
+                      void *arg)
+{
+    parser_state *ps = newparser(g, start, 0);
+
+    if (ps == NULL)
+        return NULL;
+    ps->p_callbacks = cb;
+    ps->p_arg = arg;
+    if (cb->pc_push != NULL && cb->pc_push(arg, start, 0, 0) != 0) {
+        PyParser_Delete(ps);
+        return NULL;
+    }
+    return ps;
+}
+
 void
 PyParser_Delete(parser_state *ps)
 {
     /* NB If you want to save the parse tree,
        you must set p_tree to NULL before calling delparser! */
     PyNode_Free(ps->p_tree);
+    s_free(&ps->p_stack);
+    PyMem_FREE(ps->p_keep);
     PyMem_FREE(ps);
 }
 
 
 /* PARSER STACK OPERATIONS */
 
+/* When collapsing, a nonterminal's node is made only once its second child
+   comes.  Until then its first child sits in the node's place among its
+   parent's children, at s_slot; make the node there now if that's so, and
+   move the child under it. */
 static int
-shift(register stack *s, int type, const unsigned char *str, size_t str_length, int newstate, int lineno, int col_offset)
+make(parser_state *ps, stackentry *top)
 {
+    node *n, child;
     int err;
-    assert(!s_empty(s));
-    err = PyNode_AddChild(s->s_top->s_parent, type, str, str_length, lineno, col_offset);
-    if (err)
+
+    if (top->s_slot < 0 || NCH(top->s_parent) == top->s_slot)
+        return 0;
+    n = CHILD(top->s_parent, top->s_slot);
+    child = *n;
+    n->n_type = top->s_dfa->d_type;
+    n->n_nchildren = 0;
+    n->n_child = NULL;
+    err = PyNode_AddChild(ps->p_tree, n, child.n_type, NULL, 0);
+    if (err) {
+        *n = child;
         return err;
+    }
+    *CHILD(n, 0) = child;
+    top->s_parent = n;
+    top->s_slot = -1;
+    return 0;
+}
+
+static int
+shift(parser_state *ps, int type, const unsigned char *str, size_t str_length, int newstate, int lineno, int col_offset)
+{
+    register stack *s = &ps->p_stack;
+    int err;
+    assert(!s_empty(s));
+    if (s->s_top->s_parent != NULL) {
+        if ((err = make(ps, s->s_top)) != 0)
+            return err;
+        err = PyNode_AddChild(ps->p_tree, s->s_top->s_parent, type, str, str_length);
+        if (err)
+            return err;
+    }
+    else if (ps->p_callbacks != NULL && ps->p_callbacks->pc_shift != NULL) {
+        err = ps->p_callbacks->pc_shift(ps->p_arg, type, str, str_length,
+                                        lineno, col_offset);
+        if (err)
+            return err;
+    }
 #ifndef NDEBUG
     printf("New state: %i\n", newstate);
 #endif
@@ -118,17 +274,72 @@ shift(register stack *s, int type, const unsigned char *str, size_t str_length,
 }
 
 static int
-push(register stack *s, int type, dfa *d, int newstate, int lineno, int col_offset)
+push(parser_state *ps, int type, dfa *d, int newstate, int lineno, int col_offset)
 {
+    register stack *s = &ps->p_stack;
     int err;
     register node *n;
     n = s->s_top->s_parent;
     assert(!s_empty(s));
-    err = PyNode_AddChild(n, type, NULL, 0, lineno, col_offset);
-    if (err)
-        return err;
+    if (n != NULL) {
+        if ((err = make(ps, s->s_top)) != 0)
+            return err;
+        n = s->s_top->s_parent;
+        if (ps->p_keep != NULL && !testbit(ps->p_keep, type - NT_OFFSET)) {
+            /* Put off making this node until it has a second child */
+            s->s_top->s_state = newstate;
+            if ((err = s_push(s, d, n)) != 0)
+                return err;
+            s->s_top->s_slot = NCH(n);
+            return 0;
+        }
+        err = PyNode_AddChild(ps->p_tree, n, type, NULL, 0);
+        if (err)
+            return err;
+        n = CHILD(n, NCH(n)-1);
+    }
+    else if (ps->p_callbacks != NULL && ps->p_callbacks->pc_push != NULL) {
+        err = ps->p_callbacks->pc_push(ps->p_arg, type, lineno, col_offset);
+        if (err)
+            return err;
+    }
     s->s_top->s_state = newstate;
-    return s_push(s, d, CHILD(n, NCH(n)-1));
+    return s_push(s, d, n);
+}
+
+static int
+pop(parser_state *ps)
+{
+    const parser_callbacks *cb = ps->p_callbacks;
+    int err;
+
+    if (cb != NULL && cb->pc_pop != NULL) {
+        err = cb->pc_pop(ps->p_arg, ps->p_stack.s_top->s_dfa->d_type);
+        if (err)
+            return err;
+    }
+    s_pop(&ps->p_stack);
+    return 0;
+}
+
+/* The same, for the direct-coded parser */
+
+int
+_PyParser_Shift(parser_state *ps, int type, const unsigned char *str, size_t str_length, int newstate, int lineno, int col_offset)
+{
+    return shift(ps, type, str, str_length, newstate, lineno, col_offset);
+}
+
+int
+_PyParser_Push(parser_state *ps, int type, dfa *d, int newstate, int lineno, int col_offset)
+{
+    return push(ps, type, d, newstate, lineno, col_offset);
+}
+
+int
+_PyParser_Pop(parser_state *ps)
+{
+    return pop(ps);
 }
 
 
@@ -138,39 +349,33 @@ static int
 classify(parser_state *ps, int type, register const unsigned char *str, size_t str_length)
 {
     grammar *g = ps->p_grammar;
-    register int n = g->g_ll.ll_nlabels;
-
-    if (type == NAME) {
-        register label *l = g->g_ll.ll_label;
-        register int i;
-        for (i = n; i > 0; i--, l++) {
-            if (l->lb_type != NAME ||
-                l->lb_str == NULL ||
-                l->lb_str[0] != str[0] ||
-                l->lb_str_length != str_length ||
-                memcmp(l->lb_str, str, str_length) != 0)
-
-                continue;
+    register int i;
+
+    if (type == NAME && str_length > 0) {
+        i = g->g_kwlabel[KW_SLOT(g, str, str_length)];
+        if (i >= 0) {
+            register label *l = &g->g_ll.ll_label[i];
+            if (l->lb_str[0] == str[0] &&
+                l->lb_str_length == str_length &&
+                memcmp(l->lb_str, str, str_length) == 0) {
 #ifdef PY_PARSER_REQUIRES_FUTURE_KEYWORD
-            if (ps->p_flags & CO_FUTURE_PRINT_FUNCTION &&
-                str[0] == 'p' && strncmp(str, "print", str_length == 0) {
-                break; /* no longer a keyword */
-            }
+                if (ps->p_flags & CO_FUTURE_PRINT_FUNCTION &&
+                    str_length == 5 && memcmp(str, "print", 5) == 0)
+                    goto token; /* no longer a keyword */
 #endif
-            D(printf("It's a keyword\n"));
-            return n - i;
+                D(printf("It's a keyword\n"));
+                return i;
+            }
         }
     }
 
-    {
-        register label *l = g->g_ll.ll_label;
-        register int i;
-        for (i = n; i > 0; i--, l++) {
-            if (l->lb_type == type && l->lb_str == NULL) {
-                D(printf("It's a token we know\n"));
-                return n - i;
-            }
-        }
+#ifdef PY_PARSER_REQUIRES_FUTURE_KEYWORD
+  token:
+#endif
+    i = g->g_toklabel[type];
+    if (i >= 0) {
+        D(printf("It's a token we know\n"));
+        return i;
     }
 
     D(printf("Illegal token\n"));
@@ -185,6 +390,9 @@ future_hack(parser_state *ps)
     node *ch, *cch;
     int i;
 
+    if (n == NULL)
+        return; /* Recognizing only; there's no tree to look at */
+
     /* from __future__ import ..., must have at least 4 children */
     n = CHILD(n, 0);
     if (NCH(n) < 4)
@@ -235,6 +443,13 @@ PyParser_AddToken(register parser_state *ps, register int type,
     if (ilabel < 0)
         return E_SYNTAX;
 
+#ifdef PY_PARSER_DIRECT
+    /* Hand the grammar pgen compiled to its own code */
+    if (ps->p_grammar == &_PyParser_Grammar)
+        return _PyParser_DirectAddToken(ps, ilabel, type, str, str_length,
+                                        lineno, col_offset, expected_ret);
+#endif
+
     /* Loop until the token is shifted or an error occurred */
     for (;;) {
         /* Fetch the current dfa and state */
@@ -246,15 +461,16 @@ PyParser_AddToken(register parser_state *ps, register int type,
 
         /* Check accelerator */
         if (s->s_lower <= ilabel && ilabel < s->s_upper) {
-            register int x = s->s_accel[ilabel - s->s_lower];
-            if (x != -1) {
-                if (x & (1<<7)) {
+            register const accel *ac =
+                &ps->p_grammar->g_acceltab[s->s_accel + ilabel];
+            if (ac->ac_check == s->s_accel) {
+                int x = ac->ac_arrow;
+                if (ac->ac_push >= 0) {
                     /* Push non-terminal */
-                    int nt = (x >> 8) + NT_OFFSET;
-                    int arrow = x & ((1<<7)-1);
+                    int nt = ac->ac_push + NT_OFFSET;
                     dfa *d1 = PyGrammar_FindDFA(ps->p_grammar, nt);
-                    if ((err = push(&ps->p_stack, nt,
-                                    d1, arrow,
+                    if ((err = push(ps, nt,
+                                    d1, x,
                                     lineno, col_offset)
                          ) > 0) {
 
@@ -266,7 +482,7 @@ PyParser_AddToken(register parser_state *ps, register int type,
                 }
 
                 /* Shift the token */
-                if ((err = shift(&ps->p_stack,
+                if ((err = shift(ps,
                                  type,
                                  str, str_length,
                                  x,
@@ -291,7 +507,8 @@ PyParser_AddToken(register parser_state *ps, register int type,
                            "import_stmt") == 0)
                         future_hack(ps);
 #endif
-                    s_pop(&ps->p_stack);
+                    if ((err = pop(ps)) > 0)
+                        return err;
                     if (s_empty(&ps->p_stack)) {
                         D(printf("  ACCEPT.\n"));
                         return E_DONE;
@@ -309,7 +526,8 @@ PyParser_AddToken(register parser_state *ps, register int type,
                 future_hack(ps);
 #endif
             /* Pop this dfa and try again */
-            s_pop(&ps->p_stack);
+            if ((err = pop(ps)) > 0)
+                return err;
             D(printf(" Pop ...\n"));
             if (s_empty(&ps->p_stack)) {
                 D(printf(" Error: bottom of stack.\n"));
@@ -341,7 +559,8 @@ Description
 The parser's interface is different than usual: the function addtoken()
 must be called for each token in the input.  This makes it possible to
 turn it into an incremental parsing system later.  The parsing system
-constructs a parse tree as it goes.
+constructs a parse tree as it goes, or hands each node to the caller's
+callbacks as it goes (see PyParser_NewCallbacks).
 
 A parsing rule is represented as a Deterministic Finite-state Automaton
 (DFA).  A node in a DFA represents a state of the parser; an arc represents
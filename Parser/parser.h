@@ -7,30 +7,48 @@ extern "C" {
 
 /* Parser interface */
 
-#define MAXSTACK 1500
+#define INITSTACK 32	/* Stack entries held in the parser state itself */
 
 typedef struct {
 	int		 s_state;	/* State in current DFA */
 	dfa		*s_dfa;		/* Current DFA */
 	struct _node	*s_parent;	/* Where to add next node */
+	int		 s_slot;	/* If this DFA's node isn't made yet,
+					   where its first child goes among
+					   s_parent's; else -1 */
 } stackentry;
 
 typedef struct {
 	stackentry	*s_top;		/* Top entry */
-	stackentry	 s_base[MAXSTACK];/* Array of stack entries */
+	stackentry	*s_base;	/* Array of stack entries */
 					/* NB The stack grows down */
+	int		 s_size;	/* Number of entries in s_base */
+	stackentry	 s_init[INITSTACK];/* s_base until the stack grows */
 } stack;
 
+#define s_empty(s) ((s)->s_top == &(s)->s_base[(s)->s_size])
+
 typedef struct {
 	stack	 	p_stack;	/* Stack of parser states */
 	grammar		*p_grammar;	/* Grammar to use */
 	node		*p_tree;	/* Top of parse tree */
+	const struct _parser_callbacks *p_callbacks;
+					/* Where nodes go, if not p_tree */
+	void		*p_arg;		/* First argument to p_callbacks */
+	bitset		 p_keep;	/* Nonterminals to make even with one
+					   child, if collapsing; else NULL */
 #ifdef PY_PARSER_REQUIRES_FUTURE_KEYWORD
 	unsigned long	p_flags;	/* see co_flags in Include/code.h */
 #endif
 } parser_state;
 
 parser_state *PyParser_New(grammar *g, int start);
+parser_state *PyParser_NewRecognizer(grammar *g, int start);
+parser_state *PyParser_NewCollapsing(grammar *g, int start,
+                                     const int *keep);
+parser_state *PyParser_NewCallbacks(grammar *g, int start,
+                                    const struct _parser_callbacks *cb,
+                                    void *arg);
 void PyParser_Delete(parser_state *ps);
 int PyParser_AddToken(parser_state *ps,
                       int type,
@@ -39,6 +57,18 @@ int PyParser_AddToken(parser_state *ps,
                       int *expected_ret);
 void PyGrammar_AddAccelerators(grammar *g);
 
+/* The direct-coded parser pgen writes for _PyParser_Grammar, used in
+   place of the tables when built with PY_PARSER_DIRECT */
+int _PyParser_DirectAddToken(parser_state *ps, int ilabel, int type,
+                             const unsigned char *str, size_t str_length,
+                             int lineno, int col_offset, int *expected_ret);
+int _PyParser_Shift(parser_state *ps, int type,
+                    const unsigned char *str, size_t str_length,
+                    int newstate, int lineno, int col_offset);
+int _PyParser_Push(parser_state *ps, int type, dfa *d, int newstate,
+                   int lineno, int col_offset);
+int _PyParser_Pop(parser_state *ps);
+
 #ifdef __cplusplus
 }
 #endif
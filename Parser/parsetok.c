@@ -9,10 +9,8 @@
 #include "parsetok.h"
 #include "errcode.h"
 
-int Py_TabcheckFlag;
-
 /* Forward */
-static node *parsetok(struct tok_state *, grammar *, int, perrdetail *, unsigned long *);
+static node *parsetok(struct tok_state *, parser_state *, perrdetail *, unsigned long *);
 static void initerr(perrdetail *err_ret);
 
 /* Parse input coming from a string.  Return error code, print some errors. */
@@ -34,19 +32,325 @@ PyParser_ParseStringFlags(const unsigned char *s, grammar *g, int start, perrdet
         return NULL;
     }
 
-    return parsetok(tok, g, start, err_ret, &flags);
+    return parsetok(tok, PyParser_New(g, start), err_ret, &flags);
+}
+
+/* Parse input coming from a string, leaving out the nodes of nonterminals
+   that have just one child except for those listed in `keep`, which ends
+   with 0.  The child takes the left-out node's place. */
+node *
+PyParser_ParseStringCollapsed(const unsigned char *s, grammar *g, int start, const int *keep, perrdetail *err_ret)
+{
+    struct tok_state *tok;
+    unsigned long flags = 0;
+
+    initerr(err_ret);
+
+    if ((tok = PyTokenizer_FromString(s)) == NULL) {
+        err_ret->error = E_NOMEM;
+        return NULL;
+    }
+
+    return parsetok(tok, PyParser_NewCollapsing(g, start, keep), err_ret, &flags);
+}
+
+/* Check whether input coming from a string parses, without building a
+   tree.  Return the error code, E_DONE if it parses; the rest of *err_ret
+   is set as by PyParser_ParseString. */
+int
+PyParser_RecognizeString(const unsigned char *s, grammar *g, int start, perrdetail *err_ret)
+{
+    struct tok_state *tok;
+    unsigned long flags = 0;
+
+    initerr(err_ret);
+
+    if ((tok = PyTokenizer_FromString(s)) == NULL) {
+        err_ret->error = E_NOMEM;
+        return E_NOMEM;
+    }
+
+    (void) parsetok(tok, PyParser_NewRecognizer(g, start), err_ret, &flags);
+    return err_ret->error;
+}
+
+/* Parse input coming from a string, handing the nodes to `cb` with `arg`
+   instead of building a tree.  Return the error code as
+   PyParser_RecognizeString does; a callback's own error stops the parse
+   and is returned. */
+int
+PyParser_ParseStringCallbacks(const unsigned char *s, grammar *g, int start,
+                              const parser_callbacks *cb, void *arg,
+                              perrdetail *err_ret)
+{
+    struct tok_state *tok;
+    unsigned long flags = 0;
+
+    initerr(err_ret);
+
+    if ((tok = PyTokenizer_FromString(s)) == NULL) {
+        err_ret->error = E_NOMEM;
+        return E_NOMEM;
+    }
+
+    (void) parsetok(tok, PyParser_NewCallbacks(g, start, cb, arg), err_ret, &flags);
+    return err_ret->error;
+}
+
+/* Making a node tape.  A node goes on the tape when it ends: a token when
+   it's shifted, a nonterminal when it pops.  Until then, the nonterminals
+   still open each have on tb_open the index where their subtree starts. */
+
+typedef struct {
+    const unsigned char *tb_source;
+    nodetape    *tb_tape;
+    unsigned int *tb_open;
+    int         tb_nopen;
+    int         tb_size;        /* Room in tb_open */
+} tapebuilder;
+
+#define INITOPEN        64
+
+/* Return a new tape with room for `size` nodes, or NULL on no memory */
+static nodetape *
+newtape(size_t size)
+{
+    nodetape *t;
+
+    if (size > (PY_SSIZE_T_MAX - sizeof(nodetape)) / sizeof(tapenode) ||
+        size > UINT_MAX)
+        return NULL;
+    t = (nodetape *)PyMem_MALLOC(sizeof(nodetape) +
+                                 (size - 1) * sizeof(tapenode));
+    if (t == NULL)
+        return NULL;
+    t->nt_nnodes = 0;
+    t->nt_size = (unsigned int)size;
+    return t;
+}
+
+/* Return the next node on the tape, after making room for it if need be,
+   or NULL on no memory */
+static tapenode *
+tapeadd(tapebuilder *b)
+{
+    nodetape *t = b->tb_tape;
+    size_t size;
+
+    if (t->nt_nnodes == t->nt_size) {
+        size = (size_t)t->nt_size * 2;
+        if (size > (PY_SSIZE_T_MAX - sizeof(nodetape)) / sizeof(tapenode) ||
+            size > UINT_MAX)
+            return NULL;
+        t = (nodetape *)PyMem_REALLOC(t, sizeof(nodetape) +
+                                      (size - 1) * sizeof(tapenode));
+        if (t == NULL)
+            return NULL;
+        t->nt_size = (unsigned int)size;
+        b->tb_tape = t;
+    }
+    return &t->nt_node[t->nt_nnodes++];
+}
+
+static int
+tape_push(void *arg, int type, int lineno, int col_offset)
+{
+    tapebuilder *b = (tapebuilder *)arg;
+
+    if (b->tb_nopen == b->tb_size) {
+        int size = b->tb_size * 2;
+        unsigned int *open;
+
+        open = (unsigned int *)PyMem_REALLOC(b->tb_open,
+                                             size * sizeof(unsigned int));
+        if (open == NULL)
+            return E_NOMEM;
+        b->tb_open = open;
+        b->tb_size = size;
+    }
+    b->tb_open[b->tb_nopen++] = b->tb_tape->nt_nnodes;
+    return 0;
+}
+
+static int
+tape_shift(void *arg, int type, const unsigned char *str, size_t str_length,
+           int lineno, int col_offset)
+{
+    tapebuilder *b = (tapebuilder *)arg;
+    tapenode *n = tapeadd(b);
+
+    if (n == NULL)
+        return E_NOMEM;
+    n->tn_type = type;
+    n->tn_start = (unsigned int)(str - b->tb_source);
+    n->tn_length = (unsigned int)str_length;
+    n->tn_size = 1;
+    return 0;
+}
+
+static int
+tape_pop(void *arg, int type)
+{
+    tapebuilder *b = (tapebuilder *)arg;
+    unsigned int first = b->tb_open[--b->tb_nopen];
+    tapenode *n = tapeadd(b);
+    tapenode *child;
+
+    if (n == NULL)
+        return E_NOMEM;
+    n->tn_type = type;
+    n->tn_size = b->tb_tape->nt_nnodes - first;
+    /* The node spans from its first token to the end of its last */
+    child = n - 1;
+    n->tn_start = b->tb_tape->nt_node[first].tn_start;
+    n->tn_length = child->tn_start + child->tn_length - n->tn_start;
+    return 0;
+}
+
+/* Return tape `t` with no room beyond its nodes, since it's handed on as
+   one block, slack and all.  The guess it started from is bound to be too
+   big for a source of strings and comments. */
+static nodetape *
+trimtape(nodetape *t)
+{
+    nodetape *trimmed;
+
+    if (t->nt_nnodes == t->nt_size)
+        return t;
+    trimmed = (nodetape *)PyMem_REALLOC(t, sizeof(nodetape) +
+                                        (t->nt_nnodes - 1) * sizeof(tapenode));
+    if (trimmed == NULL)
+        return t;
+    trimmed->nt_size = trimmed->nt_nnodes;
+    return trimmed;
+}
+
+static const parser_callbacks tapecallbacks = {
+    tape_push, tape_shift, tape_pop
+};
+
+/* Parse input coming from a string into a node tape.  Return the tape, or
+   NULL with the error in *err_ret. */
+nodetape *
+PyParser_ParseStringNodeTape(const unsigned char *s, grammar *g, int start, perrdetail *err_ret)
+{
+    struct tok_state *tok;
+    unsigned long flags = 0;
+    tapebuilder b;
+
+    initerr(err_ret);
+
+    if ((tok = PyTokenizer_FromString(s)) == NULL) {
+        err_ret->error = E_NOMEM;
+        return NULL;
+    }
+
+    /* A guess at the tree's size, to start with: a node for every byte */
+    b.tb_source = s;
+    b.tb_tape = newtape(tok->end - s + 1);
+    b.tb_open = (unsigned int *)PyMem_MALLOC(INITOPEN * sizeof(unsigned int));
+    b.tb_nopen = 0;
+    b.tb_size = INITOPEN;
+    if (b.tb_tape == NULL || b.tb_open == NULL) {
+        PyMem_FREE(b.tb_tape);
+        PyMem_FREE(b.tb_open);
+        PyTokenizer_Free(tok);
+        err_ret->error = E_NOMEM;
+        return NULL;
+    }
+
+    (void) parsetok(tok, PyParser_NewCallbacks(g, start, &tapecallbacks, &b),
+                    err_ret, &flags);
+    PyMem_FREE(b.tb_open);
+    if (err_ret->error != E_DONE) {
+        PyMem_FREE(b.tb_tape);
+        return NULL;
+    }
+    return trimtape(b.tb_tape);
 }
 
-/* Parse input coming from the given tokenizer structure.
+/* Parse a tape of tokens from PyTokenizer_GetBatch, holding all of the
+   tokens of `s` through its ENDMARKER. */
+
+node *
+PyParser_ParseTape(const unsigned char *s, const struct tok_tape *tape, grammar *g, int start, perrdetail *err_ret)
+{
+    parser_state *ps;
+    node *n = NULL;
+    int i;
+
+    initerr(err_ret);
+
+    if ((ps = PyParser_New(g, start)) == NULL) {
+        err_ret->error = E_NOMEM;
+        return NULL;
+    }
+
+    for (i = 0; i < tape->tt_ntokens; i++) {
+        const unsigned char *a = s + tape->tt_start[i];
+        int type = tape->tt_type[i];
+
+        if (type == ERRORTOKEN) {
+            err_ret->error = tape->tt_error;
+            break;
+        }
+        if ((err_ret->error = PyParser_AddToken(ps,
+                                                type,
+                                                a, tape->tt_length[i],
+                                                tape->tt_lineno[i],
+                                                tape->tt_col_offset[i],
+                                                &(err_ret->expected))
+             ) != E_OK) {
+
+            if (err_ret->error != E_DONE) err_ret->token = type;
+            break;
+        }
+    }
+    if (i == tape->tt_ntokens)
+        err_ret->error = E_EOF;
+
+    if (err_ret->error == E_DONE) {
+        n = ps->p_tree;
+        ps->p_tree = NULL;
+        if (n != NULL)
+            _PyNode_SetSource(n, s, NULL);
+    }
+    PyParser_Delete(ps);
+
+    if (n == NULL && tape->tt_ntokens > 0) {
+        /* Report the end of the offending token, as parsetok would */
+        linetable *lt = PyLineTable_New(s, strlen((const char *)s));
+        size_t end;
+
+        if (i == tape->tt_ntokens)
+            i--;
+        if (tape->tt_lineno[i] <= 1 && tape->tt_type[i] == ENDMARKER)
+            err_ret->error = E_EOF;
+        err_ret->lineno = tape->tt_lineno[i];
+        end = tape->tt_start[i] + tape->tt_length[i];
+        if (tape->tt_type[i] == ERRORTOKEN)
+            err_ret->offset = tape->tt_length[i];
+        else if (lt != NULL)
+            err_ret->offset = PyLineTable_Column(lt, end, LT_BYTES);
+        if (lt != NULL) {
+            err_ret->utf16_offset = PyLineTable_Column(lt, end, LT_UTF16);
+            PyLineTable_Free(lt);
+        }
+    }
+
+    return n;
+}
+
+/* Parse input coming from the given tokenizer structure with the given
+   parser, which may be NULL for lack of memory; both are freed.
    Return error code. */
 
 static node *
-parsetok(struct tok_state *tok, grammar *g, int start, perrdetail *err_ret, unsigned long *flags)
+parsetok(struct tok_state *tok, parser_state *ps, perrdetail *err_ret, unsigned long *flags)
 {
-    parser_state *ps;
     node *n;
 
-    if ((ps = PyParser_New(g, start)) == NULL) {
+    if (ps == NULL) {
         fprintf(stderr, "no mem for new parser\n");
         err_ret->error = E_NOMEM;
         PyTokenizer_Free(tok);
@@ -82,6 +386,10 @@ parsetok(struct tok_state *tok, grammar *g, int start, perrdetail *err_ret, unsi
             col_offset = a - tok->line_start;
         else
             col_offset = -1;
+        /* Tokens without text (INDENT, DEDENT, ENDMARKER) are still placed
+           where they happen, as on a tape, for the tree's line numbers */
+        if (a == NULL)
+            a = b = tok->cur;
 
         if ((err_ret->error = PyParser_AddToken(ps,
                                                 (int)type,
@@ -98,6 +406,11 @@ parsetok(struct tok_state *tok, grammar *g, int start, perrdetail *err_ret, unsi
     if (err_ret->error == E_DONE) {
         n = ps->p_tree;
         ps->p_tree = NULL;
+        if (n != NULL) {
+            /* The tree takes the line table, for its line numbers */
+            _PyNode_SetSource(n, tok->lines->lt_str, tok->lines);
+            tok->lines = NULL;
+        }
     }
     else
         n = NULL;
@@ -107,12 +420,14 @@ parsetok(struct tok_state *tok, grammar *g, int start, perrdetail *err_ret, unsi
 #endif
     PyParser_Delete(ps);
 
-    if (n == NULL) {
+    if (err_ret->error != E_DONE) {
         if (tok->lineno <= 1 && tok->done == E_EOF)
             err_ret->error = E_EOF;
         err_ret->lineno = tok->lineno;
         assert(tok->cur - tok->buf < INT_MAX);
         err_ret->offset = (int)(tok->cur - tok->buf);
+        err_ret->utf16_offset = PyLineTable_Column(
+            tok->lines, tok->cur - tok->lines->lt_str, LT_UTF16);
     }
 
     PyTokenizer_Free(tok);
@@ -126,6 +441,7 @@ initerr(perrdetail *err_ret)
     err_ret->error = E_OK;
     err_ret->lineno = 0;
     err_ret->offset = 0;
+    err_ret->utf16_offset = 0;
     err_ret->text = NULL;
     err_ret->token = -1;
     err_ret->expected = -1;
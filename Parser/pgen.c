@@ -77,15 +77,14 @@ addnfaarc(nfa *nf, int from, int to, int lbl)
 }
 
 static nfa *
-newnfa(const unsigned char *name, size_t name_length)
+newnfa(int type, const unsigned char *name, size_t name_length)
 {
     nfa *nf;
-    static int type = NT_OFFSET; /* All types will be disjunct */
 
     nf = (nfa *)PyMem_MALLOC(sizeof(nfa));
     if (nf == NULL)
         Py_FatalError("no mem for new nfa");
-    nf->nf_type = type++;
+    nf->nf_type = type;
     nf->nf_name = name;
     nf->nf_name_length = name_length;
     nf->nf_nstates = 0;
@@ -124,7 +123,8 @@ addnfa(nfagrammar *gr, const unsigned char *name, size_t name_length)
 {
     nfa *nf;
 
-    nf = newnfa(name, name_length);
+    /* All types will be disjunct */
+    nf = newnfa(NT_OFFSET + gr->gr_nnfas, name, name_length);
     gr->gr_nfa = (nfa **)PyMem_REALLOC(gr->gr_nfa,
                                        sizeof(nfa*) * (gr->gr_nnfas + 1));
     if (gr->gr_nfa == NULL)
@@ -38,16 +38,18 @@ main(int argc, char **argv)
 {
     grammar *g;
     FILE *fp;
-    char *filename, *graminit_h, *graminit_c;
+    char *filename, *graminit_h, *graminit_c, *gramdirect_c;
 
-    if (argc != 4) {
+    if (argc != 4 && argc != 5) {
         fprintf(stderr,
-            "usage: %s grammar graminit.h graminit.c\n", argv[0]);
+            "usage: %s grammar graminit.h graminit.c [gramdirect.c]\n",
+            argv[0]);
         Py_Exit(2);
     }
     filename = argv[1];
     graminit_h = argv[2];
     graminit_c = argv[3];
+    gramdirect_c = argc == 5 ? argv[4] : NULL;
     g = getgrammar(filename);
     fp = fopen(graminit_c, "w");
     if (fp == NULL) {
@@ -69,6 +71,18 @@ main(int argc, char **argv)
 #endif
     printnonterminals(g, fp);
     fclose(fp);
+    if (gramdirect_c != NULL) {
+        fp = fopen(gramdirect_c, "w");
+        if (fp == NULL) {
+            perror(gramdirect_c);
+            Py_Exit(1);
+        }
+#ifndef NDEBUG
+        printf("Writing %s ...\n", gramdirect_c);
+#endif
+        printdirect(g, fp);
+        fclose(fp);
+    }
     Py_Exit(0);
     return 0; /* Make gcc -Wall happy */
 }
@@ -105,6 +119,7 @@ getgrammar(char *filename)
     fclose(fp);
 
     g0 = meta_grammar();
+    PyGrammar_AddAccelerators(g0);
     n = PyParser_ParseString(file, g0, g0->g_start, &err);
     if (n == NULL) {
         fprintf(stderr, "Parsing error %d, line %d.\n",
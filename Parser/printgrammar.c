@@ -3,27 +3,42 @@
 
 #include "pgenheaders.h"
 #include "grammar.h"
+#include "token.h"
 
 /* Forward */
 static void printarcs(int, dfa *, FILE *);
 static void printstates(grammar *, FILE *);
 static void printdfas(grammar *, FILE *);
 static void printlabels(grammar *, FILE *);
+static void printaccel(grammar *, FILE *);
+static void printdirectstate(grammar *, dfa *, state *, int *, FILE *);
 
+/* The accelerators are computed here and written out with the rest, so
+   the parser needs no setup and never writes to the grammar. */
 void
 printgrammar(grammar *g, FILE *fp)
 {
+    if (!g->g_accel)
+        PyGrammar_AddAccelerators(g);
     fprintf(fp, "/* Generated by Parser/pgen */\n\n");
     fprintf(fp, "#include \"pgenheaders.h\"\n");
     fprintf(fp, "#include \"grammar.h\"\n");
     fprintf(fp, "PyAPI_DATA(grammar) _PyParser_Grammar;\n");
     printdfas(g, fp);
     printlabels(g, fp);
+    printaccel(g, fp);
     fprintf(fp, "grammar _PyParser_Grammar = {\n");
     fprintf(fp, "    %d,\n", g->g_ndfas);
     fprintf(fp, "    dfas,\n");
     fprintf(fp, "    {%d, labels},\n", g->g_ll.ll_nlabels);
-    fprintf(fp, "    %d\n", g->g_start);
+    fprintf(fp, "    %d,\n", g->g_start);
+    fprintf(fp, "    1,\n");
+    fprintf(fp, "    %d,\n", g->g_naccel);
+    fprintf(fp, "    acceltab,\n");
+    fprintf(fp, "    toklabel,\n");
+    fprintf(fp, "    kwlabel,\n");
+    fprintf(fp, "    0x%08xu,\n", g->g_kwseed);
+    fprintf(fp, "    %d\n", g->g_kwshift);
     fprintf(fp, "};\n");
 }
 
@@ -39,6 +54,7 @@ printnonterminals(grammar *g, FILE *fp)
     for (i = g->g_ndfas; --i >= 0; d++)
         fprintf(fp, "#define %.*s %d\n",
                 (int)d->d_name_length, d->d_name, d->d_type);
+    fprintf(fp, "\n#define N_NONTERMINALS %d\n", g->g_ndfas);
 }
 
 static void
@@ -73,8 +89,9 @@ printstates(grammar *g, FILE *fp)
             i, d->d_nstates);
         s = d->d_state;
         for (j = 0; j < d->d_nstates; j++, s++)
-            fprintf(fp, "    {%d, arcs_%d_%d},\n",
-                s->s_narcs, i, j);
+            fprintf(fp, "    {%d, arcs_%d_%d, %d, %d, %d, %d},\n",
+                s->s_narcs, i, j,
+                s->s_lower, s->s_upper, s->s_accel, s->s_accept);
         fprintf(fp, "};\n");
     }
 }
@@ -113,8 +130,217 @@ printlabels(grammar *g, FILE *fp)
         if (l->lb_str == NULL)
             fprintf(fp, "    {%d, 0},\n", l->lb_type);
         else
-            fprintf(fp, "    {%d, (const unsigned char *)\"%.*s\"},\n",
-                    l->lb_type, (int)l->lb_str_length, l->lb_str);
+            fprintf(fp, "    {%d, (const unsigned char *)\"%.*s\", %d},\n",
+                    l->lb_type, (int)l->lb_str_length, l->lb_str,
+                    (int)l->lb_str_length);
     }
     fprintf(fp, "};\n");
 }
+
+static void
+printaccel(grammar *g, FILE *fp)
+{
+    const accel *ac;
+    int i;
+    int nslots = 1 << (32 - g->g_kwshift);
+
+    fprintf(fp, "static const accel acceltab[%d] = {\n",
+            g->g_naccel > 0 ? g->g_naccel : 1);
+    ac = g->g_acceltab;
+    for (i = 0; i < g->g_naccel; i++, ac++)
+        fprintf(fp, "%s{%d, %d, %d},%s",
+                i % 4 == 0 ? "    " : " ",
+                ac->ac_check, ac->ac_arrow, ac->ac_push,
+                i % 4 == 3 || i == g->g_naccel - 1 ? "\n" : "");
+    if (g->g_naccel == 0)
+        fprintf(fp, "    {-1, 0, 0},\n");
+    fprintf(fp, "};\n");
+
+    fprintf(fp, "static const int toklabel[%d] = {\n", N_TOKENS);
+    for (i = 0; i < N_TOKENS; i++)
+        fprintf(fp, "%s%d,%s", i % 16 == 0 ? "    " : " ", g->g_toklabel[i],
+                i % 16 == 15 || i == N_TOKENS - 1 ? "\n" : "");
+    fprintf(fp, "};\n");
+
+    fprintf(fp, "static const int kwlabel[%d] = {\n", nslots);
+    for (i = 0; i < nslots; i++)
+        fprintf(fp, "%s%d,%s", i % 16 == 0 ? "    " : " ", g->g_kwlabel[i],
+                i % 16 == 15 || i == nslots - 1 ? "\n" : "");
+    fprintf(fp, "};\n");
+}
+
+/* Write the grammar's parser as C code, for PY_PARSER_DIRECT builds.  Each
+   DFA state becomes a case switching on the token's label, with the
+   accelerators' shifts and pushes as constants.  A push jumps straight to
+   the pushed DFA's initial state; only pops go back through the dispatch
+   on the stack's top entry. */
+void
+printdirect(grammar *g, FILE *fp)
+{
+    dfa *d;
+    state *s;
+    int *first;
+    char *pushed;
+    int i, j, nstates;
+    size_t size = (g->g_ndfas + 1) * sizeof(int);
+
+    if (!g->g_accel)
+        PyGrammar_AddAccelerators(g);
+    first = (int *)PyMem_MALLOC(size);
+    pushed = (char *)PyMem_MALLOC(g->g_ndfas);
+    if (first == NULL || pushed == NULL)
+        Py_FatalError("no mem for printdirect");
+    /* Only the initial states of DFAs that get pushed need a label */
+    memset(pushed, 0, g->g_ndfas);
+    for (i = 0; i < g->g_naccel; i++)
+        if (g->g_acceltab[i].ac_check != -1 && g->g_acceltab[i].ac_push >= 0)
+            pushed[g->g_acceltab[i].ac_push] = 1;
+    nstates = 0;
+    for (i = 0; i < g->g_ndfas; i++) {
+        first[i] = nstates;
+        nstates += g->g_dfa[i].d_nstates;
+    }
+    first[i] = nstates;
+
+    fprintf(fp, "/* Generated by Parser/pgen */\n\n");
+    fprintf(fp, "#include \"pgenheaders.h\"\n");
+    fprintf(fp, "#include \"grammar.h\"\n");
+    fprintf(fp, "#include \"node.h\"\n");
+    fprintf(fp, "#include \"Parser/parser.h\"\n");
+    fprintf(fp, "#include \"errcode.h\"\n\n");
+    fprintf(fp, "#ifdef PY_PARSER_REQUIRES_FUTURE_KEYWORD\n");
+    fprintf(fp, "#error \"the direct-coded parser has no future_hack\"\n");
+    fprintf(fp, "#endif\n\n");
+
+    fprintf(fp, "/* Number of each DFA's first state */\n");
+    fprintf(fp, "static const short first[%d] = {\n", g->g_ndfas);
+    for (i = 0; i < g->g_ndfas; i++)
+        fprintf(fp, "%s%d,%s", i % 16 == 0 ? "    " : " ", first[i],
+                i % 16 == 15 || i == g->g_ndfas - 1 ? "\n" : "");
+    fprintf(fp, "};\n\n");
+
+    fprintf(fp, "/* Nonzero for states that accept and have no other arc */\n");
+    fprintf(fp, "static const unsigned char poponly[%d] = {\n", nstates);
+    for (i = 0, d = g->g_dfa; i < g->g_ndfas; i++, d++) {
+        for (j = 0, s = d->d_state; j < d->d_nstates; j++, s++) {
+            int k = first[i] + j;
+            fprintf(fp, "%s%d,%s", k % 16 == 0 ? "    " : " ",
+                    s->s_accept && s->s_narcs == 1,
+                    k % 16 == 15 || k == nstates - 1 ? "\n" : "");
+        }
+    }
+    fprintf(fp, "};\n\n");
+
+    fprintf(fp, "int\n");
+    fprintf(fp, "_PyParser_DirectAddToken(parser_state *ps, int ilabel, int type,\n");
+    fprintf(fp, "                         const unsigned char *str, size_t str_length,\n");
+    fprintf(fp, "                         int lineno, int col_offset, int *expected_ret)\n");
+    fprintf(fp, "{\n");
+    fprintf(fp, "    stack *s = &ps->p_stack;\n");
+    fprintf(fp, "    dfa *dfas = ps->p_grammar->g_dfa;\n");
+    fprintf(fp, "    int err;\n\n");
+    fprintf(fp, "  dispatch:\n");
+    fprintf(fp, "    switch (first[s->s_top->s_dfa - dfas] + s->s_top->s_state) {\n");
+    for (i = 0, d = g->g_dfa; i < g->g_ndfas; i++, d++)
+        for (j = 0, s = d->d_state; j < d->d_nstates; j++, s++) {
+            fprintf(fp, "    case %d:\n", first[i] + j);
+            if (j == 0 && pushed[i])
+                fprintf(fp, "    s_%d:\n", first[i]);
+            fprintf(fp, "        /* %.*s, state %d */\n",
+                    (int)d->d_name_length, d->d_name, j);
+            printdirectstate(g, d, s, first, fp);
+        }
+    fprintf(fp, "    }\n");
+    fprintf(fp, "    return E_SYNTAX;\n\n");
+
+    fprintf(fp, "    /* Pop an accepting state that has no arc for the token, and\n");
+    fprintf(fp, "       try again in the DFA below */\n");
+    fprintf(fp, "  retry:\n");
+    fprintf(fp, "    if ((err = _PyParser_Pop(ps)) > 0)\n");
+    fprintf(fp, "        return err;\n");
+    fprintf(fp, "    if (s_empty(s))\n");
+    fprintf(fp, "        return E_SYNTAX;\n");
+    fprintf(fp, "    goto dispatch;\n\n");
+
+    fprintf(fp, "    /* After a shift, pop while in an accept-only state */\n");
+    fprintf(fp, "  pop:\n");
+    fprintf(fp, "    do {\n");
+    fprintf(fp, "        if ((err = _PyParser_Pop(ps)) > 0)\n");
+    fprintf(fp, "            return err;\n");
+    fprintf(fp, "        if (s_empty(s))\n");
+    fprintf(fp, "            return E_DONE;\n");
+    fprintf(fp, "    } while (poponly[first[s->s_top->s_dfa - dfas] + s->s_top->s_state]);\n");
+    fprintf(fp, "    return E_OK;\n");
+    fprintf(fp, "}\n");
+    PyMem_FREE(first);
+    PyMem_FREE(pushed);
+}
+
+/* Write the body of one state's case for printdirect */
+static void
+printdirectstate(grammar *g, dfa *d, state *s, int *first, FILE *fp)
+{
+    const accel *row = g->g_acceltab + s->s_accel;
+    int k, m, n;
+
+    if (s->s_upper > s->s_lower)
+        fprintf(fp, "        switch (ilabel) {\n");
+    for (k = s->s_lower; k < s->s_upper; k++) {
+        const accel *ac = &row[k];
+
+        /* Each distinct action, with every label leading to it */
+        if (ac->ac_check != s->s_accel)
+            continue;
+        for (m = s->s_lower; m < k; m++)
+            if (row[m].ac_check == s->s_accel &&
+                row[m].ac_arrow == ac->ac_arrow &&
+                row[m].ac_push == ac->ac_push)
+                break;
+        if (m < k)
+            continue;
+        for (m = k, n = 0; m < s->s_upper; m++) {
+            if (row[m].ac_check == s->s_accel &&
+                row[m].ac_arrow == ac->ac_arrow &&
+                row[m].ac_push == ac->ac_push) {
+                fprintf(fp, "%s", n % 8 == 0 ? "        " : " ");
+                fprintf(fp, "case %d:", m);
+                if (++n % 8 == 0)
+                    fprintf(fp, "\n");
+            }
+        }
+        if (n % 8 != 0)
+            fprintf(fp, "\n");
+        if (ac->ac_push >= 0) {
+            fprintf(fp, "            if ((err = _PyParser_Push(ps, %d, &dfas[%d], %d,\n",
+                    ac->ac_push + NT_OFFSET, ac->ac_push, ac->ac_arrow);
+            fprintf(fp, "                                      lineno, col_offset)) > 0)\n");
+            fprintf(fp, "                return err;\n");
+            fprintf(fp, "            goto s_%d;\n", first[ac->ac_push]);
+        }
+        else {
+            state *to = &d->d_state[ac->ac_arrow];
+            fprintf(fp, "            if ((err = _PyParser_Shift(ps, type, str, str_length, %d,\n",
+                    ac->ac_arrow);
+            fprintf(fp, "                                       lineno, col_offset)) > 0)\n");
+            fprintf(fp, "                return err;\n");
+            if (to->s_accept && to->s_narcs == 1)
+                fprintf(fp, "            goto pop;\n");
+            else
+                fprintf(fp, "            return E_OK;\n");
+        }
+    }
+    if (s->s_upper > s->s_lower)
+        fprintf(fp, "        }\n");
+    if (s->s_accept)
+        fprintf(fp, "        goto retry;\n");
+    else {
+        if (s->s_lower == s->s_upper - 1)
+            fprintf(fp, "        if (expected_ret)\n"
+                        "            *expected_ret = %d;\n",
+                    g->g_ll.ll_label[s->s_lower].lb_type);
+        else
+            fprintf(fp, "        if (expected_ret)\n"
+                        "            *expected_ret = -1;\n");
+        fprintf(fp, "        return E_SYNTAX;\n");
+    }
+}
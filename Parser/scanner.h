@@ -0,0 +1,33 @@
+/* Generated by Parser/makescanner.py from Grammar/Tokens */
+
+#ifndef Py_SCANNER_H
+#define Py_SCANNER_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A DFA over the bytes of a token.  State 0 is dead.  From state s, byte b
+   leads to _PyScan_Next[s * SCAN_NCLASSES + _PyScan_Class[b]]; the bytes of
+   class SCAN_HIGH continue a name only if they encode an identifier
+   character.  _PyScan_Accept[s] is the token type of the longest match
+   ending in s, or one of the codes below. */
+
+#define SCAN_NSTATES    67
+#define SCAN_NCLASSES   42
+#define SCAN_START      1       /* At the first byte of a token */
+#define SCAN_NAME       22      /* Inside a name */
+#define SCAN_HIGH       41      /* The class of bytes 0x80-0xff */
+
+#define SCAN_NONE       255     /* Not an accepting state */
+#define SCAN_STRING     254     /* A string's prefix and opening quote */
+#define SCAN_ERROR      253     /* A malformed number */
+#define SCAN_NUMBER1    252     /* A number, less its last byte */
+
+extern const unsigned char _PyScan_Class[256];
+extern const unsigned char _PyScan_Accept[SCAN_NSTATES];
+extern const unsigned char _PyScan_Next[SCAN_NSTATES * SCAN_NCLASSES];
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !Py_SCANNER_H */
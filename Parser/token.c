@@ -0,0 +1,151 @@
+/* Generated by Parser/maketoken.py from Grammar/Tokens */
+
+#include "Python.h"
+#include "token.h"
+
+/* Token names */
+const unsigned char *_PyParser_TokenNames[] = {
+    CUC("ENDMARKER"),
+    CUC("NAME"),
+    CUC("NUMBER"),
+    CUC("STRING"),
+    CUC("NEWLINE"),
+    CUC("INDENT"),
+    CUC("DEDENT"),
+    CUC("LPAR"),
+    CUC("RPAR"),
+    CUC("LSQB"),
+    CUC("RSQB"),
+    CUC("COLON"),
+    CUC("COMMA"),
+    CUC("SEMI"),
+    CUC("PLUS"),
+    CUC("MINUS"),
+    CUC("STAR"),
+    CUC("SLASH"),
+    CUC("VBAR"),
+    CUC("AMPER"),
+    CUC("LESS"),
+    CUC("GREATER"),
+    CUC("EQUAL"),
+    CUC("DOT"),
+    CUC("PERCENT"),
+    CUC("BACKQUOTE"),
+    CUC("LBRACE"),
+    CUC("RBRACE"),
+    CUC("EQEQUAL"),
+    CUC("NOTEQUAL"),
+    CUC("LESSEQUAL"),
+    CUC("GREATEREQUAL"),
+    CUC("TILDE"),
+    CUC("CIRCUMFLEX"),
+    CUC("LEFTSHIFT"),
+    CUC("RIGHTSHIFT"),
+    CUC("DOUBLESTAR"),
+    CUC("PLUSEQUAL"),
+    CUC("MINEQUAL"),
+    CUC("STAREQUAL"),
+    CUC("SLASHEQUAL"),
+    CUC("PERCENTEQUAL"),
+    CUC("AMPEREQUAL"),
+    CUC("VBAREQUAL"),
+    CUC("CIRCUMFLEXEQUAL"),
+    CUC("LEFTSHIFTEQUAL"),
+    CUC("RIGHTSHIFTEQUAL"),
+    CUC("DOUBLESTAREQUAL"),
+    CUC("DOUBLESLASH"),
+    CUC("DOUBLESLASHEQUAL"),
+    CUC("AT"),
+    CUC("CIRCLEDPLUS"),
+    CUC("CIRCLEDTIMES"),
+    CUC("CIRCLEDPLUSEQUAL"),
+    CUC("CIRCLEDTIMESEQUAL"),
+    CUC("OP"),
+    CUC("<ERRORTOKEN>"),
+    CUC("<N_TOKENS>")
+};
+
+/* Operator trie; see PyToken_Match in token.h */
+
+const unsigned char _PyToken_OpStart[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 23, 0, 0, 0, 18, 13, 0, 1, 2, 10, 8, 6, 9, 17, 11,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 7, 14, 16, 15, 0,
+    46, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 4, 29, 0,
+    19, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 20, 12, 21, 28, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 47, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+const unsigned char _PyToken_OpType[53] = {
+    55, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+    22, 23, 24, 25, 26, 27, 28, 55, 29, 29, 30, 31, 32, 33, 34, 35,
+    36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 55,
+    55, 51, 52, 53, 54,
+};
+
+const unsigned char _PyToken_OpArcs[53] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 3, 5, 8, 11, 13, 15, 19,
+    22, 0, 24, 0, 0, 0, 0, 26, 0, 0, 0, 0, 0, 28, 30, 32,
+    34, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 36, 0, 0, 38,
+    40, 43, 45, 0, 0,
+};
+
+const unsigned char _PyToken_OpArc[47][2] = {
+    {0x00, 0},
+    {0x3d, 33},
+    {0x00, 0},
+    {0x3d, 34},
+    {0x00, 0},
+    {0x2a, 32},
+    {0x3d, 35},
+    {0x00, 0},
+    {0x2f, 44},
+    {0x3d, 36},
+    {0x00, 0},
+    {0x3d, 39},
+    {0x00, 0},
+    {0x3d, 38},
+    {0x00, 0},
+    {0x3c, 30},
+    {0x3d, 26},
+    {0x3e, 25},
+    {0x00, 0},
+    {0x3d, 27},
+    {0x3e, 31},
+    {0x00, 0},
+    {0x3d, 22},
+    {0x00, 0},
+    {0x3d, 37},
+    {0x00, 0},
+    {0x3d, 24},
+    {0x00, 0},
+    {0x3d, 40},
+    {0x00, 0},
+    {0x3d, 41},
+    {0x00, 0},
+    {0x3d, 42},
+    {0x00, 0},
+    {0x3d, 43},
+    {0x00, 0},
+    {0x3d, 45},
+    {0x00, 0},
+    {0x8a, 48},
+    {0x00, 0},
+    {0x95, 49},
+    {0x97, 50},
+    {0x00, 0},
+    {0x3d, 51},
+    {0x00, 0},
+    {0x3d, 52},
+    {0x00, 0},
+};
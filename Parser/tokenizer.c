@@ -4,12 +4,13 @@
 #include "Python.h"
 #include "pgenheaders.h"
 
-#include <ctype.h>
 #include <assert.h>
 
 #include "tokenizer.h"
 #include "errcode.h"
 #include "decode.h"
+#include "chartype.h"
+#include "scanner.h"
 
 /* Don't ever change this -- it would break the portability of Python code */
 #define TABSIZE 8
@@ -19,69 +20,6 @@ static struct tok_state *tok_new(void);
 static unsigned int tok_nextc(struct tok_state *tok);
 static void tok_backup(struct tok_state *tok, unsigned int c);
 
-/* Token names */
-const unsigned char *_PyParser_TokenNames[] = {
-    CUC("ENDMARKER"),
-    CUC("NAME"),
-    CUC("NUMBER"),
-    CUC("STRING"),
-    CUC("NEWLINE"),
-    CUC("INDENT"),
-    CUC("DEDENT"),
-    CUC("LPAR"),
-    CUC("RPAR"),
-    CUC("LSQB"),
-    CUC("RSQB"),
-    CUC("COLON"),
-    CUC("COMMA"),
-    CUC("SEMI"),
-    CUC("PLUS"),
-    CUC("MINUS"),
-    CUC("STAR"),
-    CUC("SLASH"),
-    CUC("VBAR"),
-    CUC("AMPER"),
-    CUC("LESS"),
-    CUC("GREATER"),
-    CUC("EQUAL"),
-    CUC("DOT"),
-    CUC("PERCENT"),
-    CUC("BACKQUOTE"),
-    CUC("LBRACE"),
-    CUC("RBRACE"),
-    CUC("EQEQUAL"),
-    CUC("NOTEQUAL"),
-    CUC("LESSEQUAL"),
-    CUC("GREATEREQUAL"),
-    CUC("TILDE"),
-    CUC("CIRCUMFLEX"),
-    CUC("LEFTSHIFT"),
-    CUC("RIGHTSHIFT"),
-    CUC("DOUBLESTAR"),
-    CUC("PLUSEQUAL"),
-    CUC("MINEQUAL"),
-    CUC("STAREQUAL"),
-    CUC("SLASHEQUAL"),
-    CUC("PERCENTEQUAL"),
-    CUC("AMPEREQUAL"),
-    CUC("VBAREQUAL"),
-    CUC("CIRCUMFLEXEQUAL"),
-    CUC("LEFTSHIFTEQUAL"),
-    CUC("RIGHTSHIFTEQUAL"),
-    CUC("DOUBLESTAREQUAL"),
-    CUC("DOUBLESLASH"),
-    CUC("DOUBLESLASHEQUAL"),
-    CUC("AT"),
-    CUC("CIRCLEDPLUS"),
-    CUC("CIRCLEDTIMES"),
-    CUC("CIRCLEDPLUSEQUAL"),
-    CUC("CIRCLEDTIMESEQUAL"),
-    /* This table must match the #defines in token.h! */
-    CUC("OP"),
-    CUC("<ERRORTOKEN>"),
-    CUC("<N_TOKENS>")
-};
-
 /* Create and initialize a new tok_state structure */
 
 static struct tok_state *
@@ -91,6 +29,9 @@ tok_new(void)
         (struct tok_state *)PyMem_MALLOC(sizeof(struct tok_state));
     if (tok == NULL) return NULL;
     tok->buf = tok->cur = tok->end = tok->inp = tok->start = NULL;
+    tok->ascii_end = NULL;
+    tok->peek_start = tok->peek_end = NULL;
+    tok->peek_c = 0;
     tok->done = E_OK;
     tok->indent = 0;
     tok->indstack[0] = 0;
@@ -101,22 +42,63 @@ tok_new(void)
     tok->altwarning = 0;
     tok->alterror = 0;
     tok->altindstack[0] = 0;
-    tok->decoding_erred = 0;
     tok->cont_line = 0;
+    tok->lines = NULL;
 
     return tok;
 }
 
+/* Park the tokenizer on the first byte of an invalid UTF-8 sequence.  The
+   next token is an ERRORTOKEN, and `lineno` and `cur - buf` locate the bad
+   byte for the error report. */
+
+static void
+decodeerror(struct tok_state *tok, const unsigned char *bad)
+{
+    linetable *lt = tok->lines;
+
+    tok->lineno = PyLineTable_Line(lt, bad - lt->lt_str);
+    tok->buf = tok->line_start = lt->lt_str + LT_LINESTART(lt, tok->lineno);
+    tok->cur = tok->inp = tok->ascii_end = bad;
+    tok->done = E_DECODE;
+}
+
 /* Set up tokenizer for string */
 
 struct tok_state *
 PyTokenizer_FromString(const unsigned char *str)
 {
+    linetable *lt;
+    int line;
+
     if (str == NULL) return NULL;
     struct tok_state *tok = tok_new();
     if (tok == NULL) return NULL;
 
-    tok->buf = tok->cur = tok->inp = tok->end = str;
+    tok->buf = tok->cur = tok->inp = tok->ascii_end = tok->line_start = str;
+    tok->end = str + strlen((const char *)str);
+    lt = tok->lines = PyLineTable_New(str, tok->end - str);
+    if (lt == NULL) {
+        PyTokenizer_Free(tok);
+        return NULL;
+    }
+
+    /*
+     * Validate the input once, so that `tok_nextc` can trust every sequence
+     * it decodes.  The line table already knows which lines are pure ASCII.
+     */
+    for (line = 1; line <= lt->lt_nlines; line++) {
+        const unsigned char *bad;
+
+        if (LT_ISASCII(lt, line))
+            continue;
+        bad = validate(str + LT_LINESTART(lt, line), str + LT_LINEEND(lt, line));
+        if (bad != NULL) {
+            decodeerror(tok, bad);
+            break;
+        }
+    }
+
     return tok;
 }
 
@@ -125,22 +107,37 @@ PyTokenizer_FromString(const unsigned char *str)
 void
 PyTokenizer_Free(struct tok_state *tok)
 {
+    PyLineTable_Free(tok->lines);
     PyMem_FREE(tok);
 }
 
+/* Get next character, beyond the current run of ASCII */
+
 static unsigned int
-tok_nextc(register struct tok_state *tok)
+tok_underflow(register struct tok_state *tok)
 {
     unsigned int c;
-    const unsigned char *start;
 
     for (;;) {
+        if (tok->cur == tok->peek_start) {
+            /* Backed up over this code point; don't decode it again */
+            tok->cur = tok->peek_end;
+            return tok->peek_c;
+        }
+
         if (tok->cur != tok->inp) {
             /* Fast path */
         unicodify:
-            start = tok->cur;
+            if (*tok->cur < 0x80) {
+                tok->ascii_end = ascii_run(tok->cur, tok->inp);
+                return *tok->cur++;
+            }
+
+            /* The input was validated up front, so this can't fail */
+            tok->peek_start = tok->cur;
             tok->cur = decode(tok->cur, &c);
-            if (tok->cur - start == 0) tok->decoding_erred = 1;
+            tok->peek_end = tok->cur;
+            tok->peek_c = c;
 
 #ifndef NDEBUG
             if (c & 0xffffff00) printf("More than one code point: 0x%08x\n", c);
@@ -152,15 +149,9 @@ tok_nextc(register struct tok_state *tok)
         if (tok->done != E_OK)
             return EOF;
 
-        const unsigned char *end = CUC(strchr((const char *)tok->inp, '\n'));
-        if (end != NULL)
-            end++;
-        else {
-            end = CUC(strchr((const char *)tok->inp, '\0'));
-            if (end == tok->inp) {
-                tok->done = E_EOF;
-                return EOF;
-            }
+        if (tok->lineno >= tok->lines->lt_nlines) {
+            tok->done = E_EOF;
+            return EOF;
         }
         if (tok->start == NULL) {
             /*
@@ -171,191 +162,48 @@ tok_nextc(register struct tok_state *tok)
         }
         tok->line_start = tok->cur;
         tok->lineno++;
-        tok->inp = end;
+        tok->inp = tok->lines->lt_str + LT_LINEEND(tok->lines, tok->lineno);
 
         goto unicodify;
     }
 }
 
-/* Back-up one character */
-
-static void
-tok_backup(register struct tok_state *tok, register unsigned int c)
-{
-    if (c != EOF) {
-        // 0xxxxxxx
-        // 110xxxxx 10xxxxxx
-        // 1110xxxx 10xxxxxx 10xxxxxx
-        // 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-        while ((*--tok->cur & 0xc0) == 0x80);
-        if (tok->cur < tok->buf)
-            Py_FatalError("tok_backup: beginning of buffer");
-    }
-}
+/* Get next character */
 
-unsigned int
-PyToken_OneChar(unsigned int c)
+static inline unsigned int
+tok_nextc(register struct tok_state *tok)
 {
-    switch (c) {
-    case '(':           return LPAR;
-    case ')':           return RPAR;
-    case '[':           return LSQB;
-    case ']':           return RSQB;
-    case ':':           return COLON;
-    case ',':           return COMMA;
-    case ';':           return SEMI;
-    case '+':           return PLUS;
-    case '-':           return MINUS;
-    case '*':           return STAR;
-    case '/':           return SLASH;
-    case '|':           return VBAR;
-    case '&':           return AMPER;
-    case '<':           return LESS;
-    case '>':           return GREATER;
-    case '=':           return EQUAL;
-    case '.':           return DOT;
-    case '%':           return PERCENT;
-    case '`':           return BACKQUOTE;
-    case '{':           return LBRACE;
-    case '}':           return RBRACE;
-    case '^':           return CIRCUMFLEX;
-    case '~':           return TILDE;
-    case '@':           return AT;
-    case 0x2295:        return CIRCLEDPLUS;
-    case 0x2297:        return CIRCLEDTIMES;
-    default:            return OP;
-    }
+    if (tok->cur < tok->ascii_end)
+        /* Fastest path: inside a known run of ASCII */
+        return *tok->cur++;
+    return tok_underflow(tok);
 }
 
-unsigned int
-PyToken_TwoChars(unsigned int c1, unsigned int c2)
-{
-    switch (c1) {
-    case '=':
-        switch (c2) {
-        case '=':               return EQEQUAL;
-        }
-        break;
-    case '!':
-        switch (c2) {
-        case '=':               return NOTEQUAL;
-        }
-        break;
-    case '<':
-        switch (c2) {
-        case '>':               return NOTEQUAL;
-        case '=':               return LESSEQUAL;
-        case '<':               return LEFTSHIFT;
-        }
-        break;
-    case '>':
-        switch (c2) {
-        case '=':               return GREATEREQUAL;
-        case '>':               return RIGHTSHIFT;
-        }
-        break;
-    case '+':
-        switch (c2) {
-        case '=':               return PLUSEQUAL;
-        }
-        break;
-    case 0x2295:
-        switch (c2) {
-        case '=':               return CIRCLEDPLUSEQUAL;
-        }
-        break;
-    case '-':
-        switch (c2) {
-        case '=':               return MINEQUAL;
-        }
-        break;
-    case '*':
-        switch (c2) {
-        case '*':               return DOUBLESTAR;
-        case '=':               return STAREQUAL;
-        }
-        break;
-    case 0x2297:
-        switch (c2) {
-        case '=':               return CIRCLEDTIMESEQUAL;
-        }
-        break;
-    case '/':
-        switch (c2) {
-        case '/':               return DOUBLESLASH;
-        case '=':               return SLASHEQUAL;
-        }
-        break;
-    case '|':
-        switch (c2) {
-        case '=':               return VBAREQUAL;
-        }
-        break;
-    case '%':
-        switch (c2) {
-        case '=':               return PERCENTEQUAL;
-        }
-        break;
-    case '&':
-        switch (c2) {
-        case '=':               return AMPEREQUAL;
-        }
-        break;
-    case '^':
-        switch (c2) {
-        case '=':               return CIRCUMFLEXEQUAL;
-        }
-        break;
-    }
-    return OP;
-}
+/* Back-up one character */
 
-unsigned int
-PyToken_ThreeChars(unsigned int c1, unsigned int c2, unsigned int c3)
+static void
+tok_backup(register struct tok_state *tok, register unsigned int c)
 {
-    switch (c1) {
-    case '<':
-        switch (c2) {
-        case '<':
-            switch (c3) {
-            case '=':
-                return LEFTSHIFTEQUAL;
-            }
-            break;
-        }
-        break;
-    case '>':
-        switch (c2) {
-        case '>':
-            switch (c3) {
-            case '=':
-                return RIGHTSHIFTEQUAL;
-            }
-            break;
-        }
-        break;
-    case '*':
-        switch (c2) {
-        case '*':
-            switch (c3) {
-            case '=':
-                return DOUBLESTAREQUAL;
-            }
-            break;
-        }
-        break;
-    case '/':
-        switch (c2) {
-        case '/':
-            switch (c3) {
-            case '=':
-                return DOUBLESLASHEQUAL;
+    if (c != EOF) {
+        if (c < 0x80)
+            tok->cur--;
+        else {
+            if (tok->cur == tok->peek_end)
+                /* The usual case: `c` still occupies the peek slot */
+                tok->cur = tok->peek_start;
+            else {
+                // 0xxxxxxx
+                // 110xxxxx 10xxxxxx
+                // 1110xxxx 10xxxxxx 10xxxxxx
+                // 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+                while ((*--tok->cur & 0xc0) == 0x80);
             }
-            break;
+            /* Backed up out of the ASCII run */
+            tok->ascii_end = tok->cur;
         }
-        break;
+        if (tok->cur < tok->buf)
+            Py_FatalError("tok_backup: beginning of buffer");
     }
-    return OP;
 }
 
 static int
@@ -395,6 +243,8 @@ tok_get(register struct tok_state *tok, const unsigned char **p_start, const uns
                 col = (col/TABSIZE + 1) * TABSIZE;
                 altcol = (altcol/TABSIZE + 1) * TABSIZE;
             }
+            else if (c == '\014') /* Control-L (formfeed) */
+                col = altcol = 0; /* For Emacs users */
             else
                 break;
         }
@@ -466,55 +316,22 @@ tok_get(register struct tok_state *tok, const unsigned char **p_start, const uns
     do {
         tok->start = tok->cur; // Remember the start before incrementing.
         c = tok_nextc(tok);
-    } while (c == ' ' || c == '\t');
+    } while (Py_ISBLANK(c));
 
     /* Skip comment */
     if (c == '#') {
-        while (c != EOF && c != '\n')
-            c = tok_nextc(tok);
+        /* The comment runs to the end of the line, so jump to its newline */
+        tok->cur = tok->inp;
+        if (tok->cur[-1] == '\n')
+            tok->cur--;
+        c = tok_nextc(tok);
     }
 
     /* Check for EOF and errors now */
     if (c == EOF)
         return tok->done == E_EOF ? ENDMARKER : ERRORTOKEN;
 
-    /* Identifier (most frequent token!) */
-    if (isalpha(c) || c == '_') {
-        /* Process r"", u"" and ur"" */
-        switch (c) {
-        case 'b':
-        case 'B':
-            c = tok_nextc(tok);
-            if (c == 'r' || c == 'R')
-                c = tok_nextc(tok);
-            if (c == '"' || c == '\'')
-                goto letter_quote;
-            break;
-        case 'r':
-        case 'R':
-            c = tok_nextc(tok);
-            if (c == '"' || c == '\'')
-                goto letter_quote;
-            break;
-        case 'u':
-        case 'U':
-            c = tok_nextc(tok);
-            if (c == 'r' || c == 'R')
-                c = tok_nextc(tok);
-            if (c == '"' || c == '\'')
-                goto letter_quote;
-            break;
-        }
-        while (c != EOF && (isalnum(c) || c == '_')) {
-            c = tok_nextc(tok);
-        }
-        tok_backup(tok, c);
-        *p_start = tok->start;
-        *p_end = tok->cur;
-        return NAME;
-    }
-
-    /* String continuation */
+    /* Newline */
     if (c == '\n') {
         tok->atbol = 1;
         if (blankline || tok->level > 0)
@@ -525,160 +342,136 @@ tok_get(register struct tok_state *tok, const unsigned char **p_start, const uns
         return NEWLINE;
     }
 
-    /* Period or number starting with period? */
-    if (c == '.') {
+    /* Line continuation */
+    if (c == '\\') {
         c = tok_nextc(tok);
-        if (isdigit(c)) {
-            goto fraction;
-        }
-        else {
-            tok_backup(tok, c);
-            *p_start = tok->start;
-            *p_end = tok->cur;
-            return DOT;
+        if (c != '\n') {
+            tok->done = E_LINECONT;
+            tok->cur = tok->inp;
+            return ERRORTOKEN;
         }
+        tok->cont_line = 1;
+        goto again; /* Read next line */
     }
 
-    /* Number */
-    if (isdigit(c)) {
-        if (c == '0') {
-            /* Hex, octal or binary -- maybe. */
-            c = tok_nextc(tok);
-            if (c == '.')
-                goto fraction;
-#ifndef WITHOUT_COMPLEX
-            if (c == 'j' || c == 'J')
-                goto imaginary;
-#endif
-            if (c == 'x' || c == 'X') {
-
-                /* Hex */
-                c = tok_nextc(tok);
-                if (!isxdigit(c)) {
-                    tok->done = E_TOKEN;
-                    tok_backup(tok, c);
-                    return ERRORTOKEN;
-                }
-                do {
-                    c = tok_nextc(tok);
-                } while (isxdigit(c));
-            }
-            else if (c == 'o' || c == 'O') {
-                /* Octal */
-                c = tok_nextc(tok);
-                if (c < '0' || c >= '8') {
-                    tok->done = E_TOKEN;
-                    tok_backup(tok, c);
-                    return ERRORTOKEN;
-                }
-                do {
-                    c = tok_nextc(tok);
-                } while ('0' <= c && c < '8');
+    /*
+     * Names, numbers, string prefixes and operators: run the DFA over the
+     * token's bytes, remembering the longest match.  A '\n' or the NUL
+     * after the last line stops every state, so the DFA can't run off the
+     * end of the line.
+     */
+    {
+        const unsigned char *p = tok->start;
+        const unsigned char *last = NULL;
+        unsigned int state = SCAN_START;
+        unsigned int accept = SCAN_NONE;
+        int type;
+
+        if (c >= 0x80) {
+            if (!Py_ISIDSTART(c)) {
+                /* Operators beginning outside ASCII, else a lone character */
+                int length = PyToken_Match(tok->start, tok->inp, &type);
+                if (length > 0)
+                    tok->cur = tok->start + length;
+                else
+                    type = OP;
+                *p_start = tok->start;
+                *p_end = tok->cur;
+                return type;
             }
-            else if (c == 'b' || c == 'B') {
-                /* Binary */
-                c = tok_nextc(tok);
-                if (c != '0' && c != '1') {
-                    tok->done = E_TOKEN;
-                    tok_backup(tok, c);
-                    return ERRORTOKEN;
-                }
-                do {
-                    c = tok_nextc(tok);
-                } while (c == '0' || c == '1');
+            p = last = tok->cur;
+            state = SCAN_NAME;
+            accept = NAME;
+        }
+
+        for (;;) {
+            unsigned int cls = _PyScan_Class[*p];
+            unsigned int next = _PyScan_Next[state * SCAN_NCLASSES + cls];
+            if (next == 0)
+                break;
+            if (cls == SCAN_HIGH) {
+                /* Only names continue outside ASCII */
+                unsigned int u;
+                const unsigned char *q = decode(p, &u);
+                if (!Py_ISIDCONTINUE(u))
+                    break;
+                p = q;
             }
-            else {
-                int found_decimal = 0;
-                /* Octal; c is first char of it */
-                /* There's no 'isoctdigit' macro, sigh */
-                while ('0' <= c && c < '8') {
-                    c = tok_nextc(tok);
-                }
-                if (isdigit(c)) {
-                    found_decimal = 1;
-                    do {
-                        c = tok_nextc(tok);
-                    } while (isdigit(c));
-                }
-                if (c == '.')
-                    goto fraction;
-                else if (c == 'e' || c == 'E')
-                    goto exponent;
-#ifndef WITHOUT_COMPLEX
-                else if (c == 'j' || c == 'J')
-                    goto imaginary;
-#endif
-                else if (found_decimal) {
-                    tok->done = E_TOKEN;
-                    tok_backup(tok, c);
-                    return ERRORTOKEN;
-                }
+            else
+                p++;
+            state = next;
+            if (_PyScan_Accept[state] != SCAN_NONE) {
+                accept = _PyScan_Accept[state];
+                last = p;
             }
-            if (c == 'l' || c == 'L')
-                c = tok_nextc(tok);
         }
-        else {
-            /* Decimal */
-            do {
-                c = tok_nextc(tok);
-            } while (isdigit(c));
-            if (c == 'l' || c == 'L')
-                c = tok_nextc(tok);
-            else {
-                /* Accept floating point numbers. */
-                if (c == '.') {
-        fraction:
-                    /* Fraction */
-                    do {
-                        c = tok_nextc(tok);
-                    } while (isdigit(c));
-                }
-                if (c == 'e' || c == 'E') {
-                    unsigned int e;
-                  exponent:
-                    e = c;
-                    /* Exponent part */
-                    c = tok_nextc(tok);
-                    if (c == '+' || c == '-') {
-                        c = tok_nextc(tok);
-                        if (!isdigit(c)) {
-                            tok->done = E_TOKEN;
-                            tok_backup(tok, c);
-                            return ERRORTOKEN;
-                        }
-                    } else if (!isdigit(c)) {
-                        tok_backup(tok, c);
-                        tok_backup(tok, e);
-                        *p_start = tok->start;
-                        *p_end = tok->cur;
-                        return NUMBER;
-                    }
-                    do {
-                        c = tok_nextc(tok);
-                    } while (isdigit(c));
-                }
-#ifndef WITHOUT_COMPLEX
-                if (c == 'j' || c == 'J')
-                    /* Imaginary part */
-        imaginary:
-                    c = tok_nextc(tok);
-#endif
-            }
+
+        switch (accept) {
+        case SCAN_NONE:
+            /* Not the start of any token; a lone punctuation character */
+            tok->cur = tok->start + 1;
+            type = OP;
+            break;
+        case SCAN_STRING:
+            tok->cur = last;
+            c = last[-1];
+            goto letter_quote;
+        case SCAN_ERROR:
+            tok->done = E_TOKEN;
+            tok->cur = last;
+            return ERRORTOKEN;
+        case SCAN_NUMBER1:
+            /* "09e": the 'e' starts the next token */
+            tok->cur = last - 1;
+            type = NUMBER;
+            break;
+        default:
+            tok->cur = last;
+            type = accept;
+            break;
         }
-        tok_backup(tok, c);
+
+        /* Keep track of parentheses nesting level */
+        switch (type) {
+        case LPAR:
+        case LSQB:
+        case LBRACE:
+            tok->level++;
+            break;
+        case RPAR:
+        case RSQB:
+        case RBRACE:
+            tok->level--;
+            break;
+        }
+
         *p_start = tok->start;
         *p_end = tok->cur;
-        return NUMBER;
+        return type;
     }
 
   letter_quote:
-    /* String */
-    if (c == '\'' || c == '"') {
+    /* String; c is its opening quote */
+    {
         Py_ssize_t quote2 = tok->cur - tok->start + 1;
         unsigned int quote = c;
         unsigned int triple = 0;
         unsigned int tripcount = 0;
         for (;;) {
+            if (tok->cur < tok->inp) {
+                /*
+                 * Jump over the body to the next byte that matters: a quote,
+                 * a backslash or the end of the line.
+                 */
+                const unsigned char *stop =
+                    memchr2(tok->cur, tok->inp, (int)quote, '\\');
+                if (stop == tok->inp && stop[-1] == '\n')
+                    stop--;
+                if (stop != tok->cur) {
+                    tok->cur = stop;
+                    tripcount = 0;
+                }
+            }
             c = tok_nextc(tok);
             if (c == '\n') {
                 if (!triple) {
@@ -727,67 +520,69 @@ tok_get(register struct tok_state *tok, const unsigned char **p_start, const uns
         *p_end = tok->cur;
         return STRING;
     }
-
-    /* Line continuation */
-    if (c == '\\') {
-        c = tok_nextc(tok);
-        if (c != '\n') {
-            tok->done = E_LINECONT;
-            tok->cur = tok->inp;
-            return ERRORTOKEN;
-        }
-        tok->cont_line = 1;
-        goto again; /* Read next line */
-    }
-
-    /* Check for two-character token */
-    {
-        unsigned int c2 = tok_nextc(tok);
-        unsigned int token = PyToken_TwoChars(c, c2);
-        if (token != OP) {
-            unsigned int c3 = tok_nextc(tok);
-            unsigned int token3 = PyToken_ThreeChars(c, c2, c3);
-            if (token3 != OP) {
-                token = token3;
-            } else {
-                tok_backup(tok, c3);
-            }
-            *p_start = tok->start;
-            *p_end = tok->cur;
-            return token;
-        }
-        tok_backup(tok, c2);
-    }
-
-    /* Keep track of parentheses nesting level */
-    switch (c) {
-    case '(':
-    case '[':
-    case '{':
-        tok->level++;
-        break;
-    case ')':
-    case ']':
-    case '}':
-        tok->level--;
-        break;
-    }
-
-    /* Punctuation character */
-    *p_start = tok->start;
-    *p_end = tok->cur;
-    return PyToken_OneChar(c);
 }
 
 unsigned int
 PyTokenizer_Get(struct tok_state *tok, const unsigned char **p_start, const unsigned char **p_end)
 {
-    unsigned int result = tok_get(tok, p_start, p_end);
-    if (tok->decoding_erred) {
-        result = ERRORTOKEN;
-        tok->done = E_DECODE;
+    return tok_get(tok, p_start, p_end);
+}
+
+/* Fill `tape` with the next tokens, up to its size, and return how many.
+   The tape stops early after an ENDMARKER or ERRORTOKEN.  Tokens are spans
+   of the source string, which must outlive the tape.  As in parsetok, an
+   ENDMARKER reached inside an indented block turns into the NEWLINE and
+   DEDENTs that close it, so a tape holds exactly what the parser sees. */
+
+int
+PyTokenizer_GetBatch(struct tok_state *tok, struct tok_tape *tape)
+{
+    const unsigned char *str = tok->lines->lt_str;
+    int i;
+
+    tape->tt_error = E_OK;
+    for (i = 0; i < tape->tt_size; i++) {
+        const unsigned char *a, *b;
+        unsigned int type;
+
+        type = tok_get(tok, &a, &b);
+        if (type == ENDMARKER && tok->indent != 0) {
+            type = NEWLINE;
+            tok->pendin = -tok->indent;
+            tok->indent = 0;
+        }
+
+        tape->tt_type[i] = (unsigned char)type;
+        tape->tt_lineno[i] = tok->lineno;
+        if (a != NULL) {
+            tape->tt_start[i] = (unsigned int)(a - str);
+            tape->tt_length[i] = (unsigned int)(b - a);
+        }
+        else {
+            tape->tt_start[i] = (unsigned int)(tok->cur - str);
+            tape->tt_length[i] = 0;
+        }
+        if (a != NULL && a >= tok->line_start)
+            tape->tt_col_offset[i] = (int)(a - tok->line_start);
+        else
+            tape->tt_col_offset[i] = -1;
+
+        if (type == ERRORTOKEN) {
+            /* Record the span parsetok reports: `buf` up to `cur` */
+            tape->tt_start[i] = (unsigned int)(tok->buf - str);
+            tape->tt_length[i] = (unsigned int)(tok->cur - tok->buf);
+            tape->tt_error = tok->done;
+            i++;
+            break;
+        }
+        if (type == ENDMARKER) {
+            i++;
+            break;
+        }
     }
-    return result;
+
+    tape->tt_ntokens = i;
+    return i;
 }
 
 #ifndef NDEBUG
@@ -7,6 +7,7 @@ extern "C" {
 /* Tokenizer interface */
 
 #include "token.h"      /* For token types */
+#include "linetable.h"
 
 #define MAXINDENT 100   /* Max indentation level */
 
@@ -19,6 +20,11 @@ struct tok_state {
     const unsigned char *inp;    /* End of current line */
     const unsigned char *end;    /* End of input buffer */
     const unsigned char *start;  /* Start of current token if not NULL */
+    const unsigned char *ascii_end; /* cur <= ascii_end: [cur, ascii_end) is ASCII */
+    /* Peek slot: the last non-ASCII code point decoded and its byte span */
+    const unsigned char *peek_start;
+    const unsigned char *peek_end;
+    unsigned int peek_c;
     int done;           /* E_OK normally, E_EOF at EOF, otherwise error code */
     /* NB If done != E_OK, cur must be == inp!!! */
     int indent;         /* Current indentation index */
@@ -33,14 +39,28 @@ struct tok_state {
     int alterror;       /* Issue error if alternate tabs don't match */
     int altindstack[MAXINDENT];         /* Stack of alternate indents */
 
-    int decoding_erred;         /* whether erred in decoding  */
     int cont_line;              /* whether we are in a continuation line */
     const unsigned char* line_start;     /* pointer to start of current line */
+    linetable *lines;   /* Line starts of the whole input */
+};
+
+/* Token tape: a run of tokens as parallel arrays.  The caller provides the
+   arrays, each with room for tt_size tokens. */
+struct tok_tape {
+    int tt_size;                /* Capacity of each array */
+    int tt_ntokens;             /* Number of tokens held */
+    int tt_error;               /* E_OK, or tok->done after an ERRORTOKEN */
+    unsigned char *tt_type;     /* Token type */
+    unsigned int *tt_start;     /* Byte offset of the token in the source */
+    unsigned int *tt_length;    /* Its length in bytes */
+    int *tt_lineno;             /* Line number, as passed to the parser */
+    int *tt_col_offset;         /* Byte column, or -1 */
 };
 
 extern struct tok_state *PyTokenizer_FromString(const unsigned char *);
 extern void PyTokenizer_Free(struct tok_state *);
 extern unsigned int PyTokenizer_Get(struct tok_state *, const unsigned char **, const unsigned char **);
+extern int PyTokenizer_GetBatch(struct tok_state *, struct tok_tape *);
 
 #ifdef __cplusplus
 }
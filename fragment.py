@@ -16,3 +16,6 @@ x = (a + b).___oplus___(b)
 
 x = a.___oplus___(b + c)
 x = a + d   ⊕ (v -t⊕inj(m  ⊗ t)) ⊗  a ⊕  n
+
+y = 1  # A paren goes before this comment, not in it
+a ⊕ b